@@ -0,0 +1,359 @@
+#include <logger/logger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/monitoring/monitoring.h"
+
+// Набор замеров для логгера и сборщиков метрик. Результат — плоский JSON {"имя": значение},
+// который можно сравнить с сохранённым базовым файлом:
+//   bench --output build/bench.json [--baseline bench/baseline.json] [--threshold 0.25]
+//         [--tail-threshold 1.0] [--repeat 5] [--quick]
+// Метрики с суффиксом _ns — чем меньше, тем лучше; с суффиксом _per_sec — чем больше, тем лучше.
+// Весь набор прогоняется repeat раз, в JSON попадает медиана каждой метрики. Хвостовые задержки
+// (p99, p999) сравниваются с отдельным, более мягким порогом и по умолчанию только печатаются.
+// Строковые поля (например, выбранный путь записи) описывают окружение и в сравнении не участвуют.
+
+using Clock   = std::chrono::steady_clock;
+using Metrics = std::map<std::string, double>;
+using Info    = std::map<std::string, std::string>;
+
+namespace {
+
+const char *benchLogFile = "bench_log.txt";
+
+double percentile(std::vector<double> &sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Пропускная способность и задержки saveMessage для заданного числа потоков и длины сообщения
+void benchSaveMessage(Metrics &metrics, int threadCount, size_t messageSize, bool buffered, size_t totalMessages) {
+    std::filesystem::remove(benchLogFile);
+
+    std::vector<std::vector<double>> latencies(threadCount);
+    double                           seconds;
+    {
+        Logger logger(benchLogFile, "info");
+        if (buffered) {
+            logger.enableThreadBuffering();
+        }
+
+        const std::string message(messageSize, 'x');
+        const size_t      perThread = totalMessages / threadCount;
+
+        auto producer = [&](int id) {
+            auto &samples = latencies[id];
+            samples.reserve(perThread);
+            for (size_t i = 0; i < perThread; ++i) {
+                auto start = Clock::now();
+                logger.saveMessage(message, LogLevel::info);
+                samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+            }
+        };
+
+        auto                     start = Clock::now();
+        std::vector<std::thread> threads;
+        for (int id = 0; id < threadCount; ++id) {
+            threads.emplace_back(producer, id);
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        logger.flush();  // В буферизованном режиме время включает запись на диск
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    std::filesystem::remove(benchLogFile);
+
+    std::vector<double> all;
+    for (auto &samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    std::string name = std::string("saveMessage/") + (buffered ? "buffered" : "sync") +
+                       "/threads=" + std::to_string(threadCount) + "/size=" + std::to_string(messageSize);
+    metrics[name + "/msgs_per_sec"] = all.size() / seconds;
+    metrics[name + "/p50_ns"]       = percentile(all, 0.50);
+    metrics[name + "/p99_ns"]       = percentile(all, 0.99);
+    metrics[name + "/p999_ns"]      = percentile(all, 0.999);
+}
+
+// Среднее время одного вызова
+template <class Function>
+double nanosPerCall(size_t iterations, Function function) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        function();
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+}
+
+void benchTimestamp(Metrics &metrics, size_t iterations) {
+    Logger logger(benchLogFile, "info");
+    size_t sink = 0;
+    metrics["getcurrentTime/ns"] = nanosPerCall(iterations, [&]() { sink += logger.getcurrentTime().size(); });
+    if (sink == 0) {
+        std::cerr << "unexpected empty timestamp\n";
+    }
+    std::filesystem::remove(benchLogFile);
+}
+
+// Среднее время вызова, когда между вызовами проходит не меньше pause (время ожидания не учитывается)
+template <class Function>
+double nanosPerSpacedCall(size_t iterations, std::chrono::milliseconds pause, Function function) {
+    Clock::duration total{};
+    for (size_t i = 0; i < iterations; ++i) {
+        std::this_thread::sleep_for(pause);
+        auto start = Clock::now();
+        function();
+        total += Clock::now() - start;
+    }
+    return std::chrono::duration<double, std::nano>(total).count() / iterations;
+}
+
+void benchCollectors(Metrics &metrics, size_t iterations, size_t cpuSamples) {
+    {
+        // Уровень error у логгера: замеряется сбор метрики, а не запись на диск
+        Logger        logger(benchLogFile, "error");
+        SystemMonitor monitor(logger);
+        // Счётчики /proc/stat растут раз в тик (обычно 10 мс): при более частых вызовах монитор не может
+        // посчитать разницу и пишет в журнал ошибку вместо замера
+        monitor.monitorCPU(LogLevel::error);
+        metrics["monitorCPU/ns"] = nanosPerSpacedCall(cpuSamples, std::chrono::milliseconds(11),
+                                                      [&]() { monitor.monitorCPU(LogLevel::error); });
+        metrics["monitorMemory/ns"] = nanosPerCall(iterations, [&]() { monitor.monitorMemory(LogLevel::error); });
+        metrics["monitorDisk/ns"]   = nanosPerCall(iterations, [&]() { monitor.monitorDisk(LogLevel::error); });
+    }
+    std::filesystem::remove(benchLogFile);
+    std::filesystem::remove("output_app.txt");
+}
+
+// Запись готовых записей напрямую в приёмник: ofstream против io_uring и его запасного пути через pwrite.
+// Имя метрики io_uring не зависит от хоста, фактический путь записывается в info
+void benchFileSinks(Metrics &metrics, Info &info, size_t totalMessages) {
+    const char       *sinkFile = "bench_sink.txt";
+    const std::string message(127, 'x');
+
+    char     *text;
+    RecordPtr record = makeRecord(std::chrono::system_clock::now(), LogLevel::info, message.size() + 1, text);
+    std::memcpy(text, message.data(), message.size());
+    text[message.size()] = '\n';
+
+    auto run = [&](const std::string &name, LogSink &sink) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < totalMessages; ++i) {
+            sink.write(record);
+        }
+        sink.flush();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        metrics["sink/" + name + "/msgs_per_sec"] = totalMessages / seconds;
+    };
+
+    {
+        FileSink sink(sinkFile);
+        run("ofstream", sink);
+    }
+    std::filesystem::remove(sinkFile);
+    {
+        IoUringFileSink sink(sinkFile);
+        info["sink/io_uring/path"] = sink.usesIoUring() ? "io_uring" : "pwrite_fallback";
+        run("io_uring", sink);
+    }
+    std::filesystem::remove(sinkFile);
+    {
+        IoUringFileSink sink(sinkFile, LogLevel::unknown, 64 * 1024, 4, false);
+        run("pwrite", sink);
+    }
+    std::filesystem::remove(sinkFile);
+}
+
+void writeJson(const Metrics &metrics, const Info &info, std::ostream &out) {
+    out << "{\n";
+    size_t       index = 0;
+    const size_t total = metrics.size() + info.size();
+    for (const auto &[name, value] : info) {
+        out << "  \"" << name << "\": \"" << value << "\"" << (++index < total ? ",\n" : "\n");
+    }
+    for (const auto &[name, value] : metrics) {
+        char number[64];
+        std::snprintf(number, sizeof(number), "%.3f", value);
+        out << "  \"" << name << "\": " << number << (++index < total ? ",\n" : "\n");
+    }
+    out << "}\n";
+}
+
+void readJson(const std::string &filename, Metrics &metrics, Info &info) {
+    std::ifstream     file(filename);
+    std::stringstream content;
+    content << file.rdbuf();
+    const std::string text = content.str();
+
+    const std::regex number("\"([^\"]+)\"\\s*:\\s*([-+0-9.eE]+)");
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), number); it != std::sregex_iterator(); ++it) {
+        metrics[(*it)[1]] = std::stod((*it)[2]);
+    }
+    const std::regex quoted("\"([^\"]+)\"\\s*:\\s*\"([^\"]*)\"");
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), quoted); it != std::sregex_iterator(); ++it) {
+        info[(*it)[1]] = (*it)[2];
+    }
+}
+
+// Медиана каждой метрики по повторам
+Metrics medianOf(const std::vector<Metrics> &runs) {
+    std::map<std::string, std::vector<double>> values;
+    for (const Metrics &run : runs) {
+        for (const auto &[name, value] : run) {
+            values[name].push_back(value);
+        }
+    }
+    Metrics median;
+    for (auto &[name, samples] : values) {
+        std::sort(samples.begin(), samples.end());
+        const size_t middle = samples.size() / 2;
+        median[name] = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+    }
+    return median;
+}
+
+bool endsWith(const std::string &text, const std::string &suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool isTailLatency(const std::string &name) { return endsWith(name, "/p99_ns") || endsWith(name, "/p999_ns"); }
+
+// Возвращает число метрик, пропавших или ухудшившихся больше порога. Для хвостовых задержек свой порог;
+// tailThreshold <= 0 — хвосты только печатаются и на результат не влияют
+int compareWithBaseline(const Metrics &current, const Metrics &baseline, double threshold, double tailThreshold) {
+    int regressions = 0;
+    for (const auto &[name, base] : baseline) {
+        auto it = current.find(name);
+        if (it == current.end()) {
+            // Пропавший замер не должен молча проходить сравнение
+            ++regressions;
+            std::printf("MISSING    %-50s baseline %12.1f\n", name.c_str(), base);
+            continue;
+        }
+        if (base <= 0) {
+            continue;
+        }
+
+        const bool   higherIsBetter = endsWith(name, "_per_sec");
+        const double change         = higherIsBetter ? (base - it->second) / base : (it->second - base) / base;
+        if (isTailLatency(name)) {
+            if (tailThreshold > 0 && change > tailThreshold) {
+                ++regressions;
+                std::printf("REGRESSION %-50s baseline %12.1f current %12.1f (%+.1f%%)\n", name.c_str(), base,
+                            it->second, change * 100);
+            } else if (tailThreshold <= 0 && change > threshold) {
+                std::printf("TAIL       %-50s baseline %12.1f current %12.1f (%+.1f%%)\n", name.c_str(), base,
+                            it->second, change * 100);
+            }
+        } else if (change > threshold) {
+            ++regressions;
+            std::printf("REGRESSION %-50s baseline %12.1f current %12.1f (%+.1f%%)\n", name.c_str(), base, it->second,
+                        change * 100);
+        }
+    }
+    return regressions;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string output    = "bench.json";
+    std::string baseline;
+    double      threshold     = 0.25;
+    double      tailThreshold = 0;
+    int         repeat        = 5;
+    bool        quick         = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            threshold = std::atof(argv[++i]);
+        } else if (arg == "--tail-threshold" && i + 1 < argc) {
+            tailThreshold = std::atof(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--quick") {
+            quick = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--output file.json] [--baseline baseline.json] [--threshold 0.25]"
+                         " [--tail-threshold 1.0] [--repeat 5] [--quick]\n";
+            return -1;
+        }
+    }
+
+    const size_t totalMessages = quick ? 20000 : 200000;
+    const size_t iterations    = quick ? 2000 : 20000;
+
+    // Однократный замер хвостов и пропускной способности слишком шумный для сравнения с порогом
+    std::vector<Metrics> runs(repeat);
+    Info                 info;
+    for (Metrics &run : runs) {
+        for (bool buffered : {false, true}) {
+            for (int threads : {1, 2, 4, 8}) {
+                for (size_t size : {16, 128, 1024}) {
+                    benchSaveMessage(run, threads, size, buffered, totalMessages);
+                }
+            }
+        }
+        benchTimestamp(run, iterations * 10);
+        benchCollectors(run, iterations, quick ? 50 : 200);
+        benchFileSinks(run, info, totalMessages);
+    }
+    const Metrics metrics = medianOf(runs);
+
+    std::ofstream file(output);
+    if (!file) {
+        std::cerr << "Unable to open output file: " << output << "\n";
+        return -1;
+    }
+    writeJson(metrics, info, file);
+    writeJson(metrics, info, std::cout);
+
+    if (!baseline.empty()) {
+        if (!std::filesystem::exists(baseline)) {
+            std::cerr << "Baseline not found: " << baseline << "\n";
+            return -1;
+        }
+        Metrics baseMetrics;
+        Info    baseInfo;
+        readJson(baseline, baseMetrics, baseInfo);
+        for (const auto &[name, value] : baseInfo) {
+            auto it = info.find(name);
+            if (it != info.end() && it->second != value) {
+                std::printf("NOTE       %-50s baseline %s, current %s\n", name.c_str(), value.c_str(),
+                            it->second.c_str());
+            }
+        }
+        int regressions = compareWithBaseline(metrics, baseMetrics, threshold, tailThreshold);
+        if (regressions > 0) {
+            std::cerr << regressions << " metric(s) missing or regressed by more than " << threshold * 100 << "%\n";
+            return 1;
+        }
+        std::cout << "No regressions against " << baseline << "\n";
+    }
+    return 0;
+}
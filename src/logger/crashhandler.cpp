@@ -0,0 +1,214 @@
+#include "crashhandler.h"
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <mutex>
+
+namespace {
+
+constexpr size_t maxCrashSlots   = 256;
+constexpr size_t maxCrashBuffers = 64;
+constexpr int    crashSignals[]  = {SIGSEGV, SIGABRT, SIGTERM};
+
+CrashSlot   crashSlots[maxCrashSlots];
+CrashBuffer crashBuffers[maxCrashBuffers];
+
+std::atomic<int>      crashFd{-1};
+std::atomic<uint64_t> crashOwner{0};
+
+constexpr size_t alternateStackSize = 64 * 1024;
+
+// Стек сигналов потока; снимается и освобождается при завершении потока
+struct AlternateStack {
+    void *memory = nullptr;
+
+    ~AlternateStack() {
+        if (memory == nullptr) {
+            return;
+        }
+        stack_t disabled{};
+        disabled.ss_flags = SS_DISABLE;
+        sigaltstack(&disabled, nullptr);
+        munmap(memory, alternateStackSize);
+    }
+};
+
+thread_local AlternateStack alternateStack;
+
+std::mutex       installMutex;
+bool             handlersInstalled = false;
+struct sigaction previousActions[NSIG];
+
+void writeAll(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+void pwriteAll(int fd, const char *data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+}
+
+// Буферы приёмников пишутся первыми: записи из слотов уходят через O_APPEND в конец файла и окажутся
+// за ними, а запоздавшая запись тех же буферов из ядра ляжет на те же байты
+void drainCrashBuffers() {
+    for (auto &buffer : crashBuffers) {
+        const char    *data   = buffer.data.load(std::memory_order_acquire);
+        const int      fd     = buffer.fd.load(std::memory_order_acquire);
+        const uint64_t offset = buffer.offset.load(std::memory_order_acquire);
+        const size_t   size   = buffer.size.load(std::memory_order_acquire);
+        // Смещение сменилось между чтениями — буфер уже отправлен и заполняется заново
+        if (data == nullptr || fd < 0 || size == 0 || buffer.offset.load(std::memory_order_acquire) != offset) {
+            continue;
+        }
+        pwriteAll(fd, data, size, offset);
+    }
+}
+
+// Только async-signal-safe операции: атомарные чтения, pwrite(2) и write(2)
+void crashSignalHandler(int signal) {
+    const int      fd    = crashFd.load(std::memory_order_acquire);
+    const uint64_t owner = crashOwner.load(std::memory_order_acquire);
+
+    drainCrashBuffers();
+    if (fd >= 0) {
+        for (auto &slot : crashSlots) {
+            const uint64_t slotOwner = slot.owner.load(std::memory_order_acquire);
+            if (slotOwner == 0 || (owner != 0 && slotOwner != owner)) {
+                continue;
+            }
+
+            const RecordPtr *records = slot.records.load(std::memory_order_acquire);
+            const size_t     mask    = slot.mask.load(std::memory_order_acquire);
+            const size_t     begin   = slot.begin.load(std::memory_order_acquire);
+            const size_t     end     = slot.end.load(std::memory_order_acquire);
+            if (records == nullptr) {
+                continue;
+            }
+            for (size_t i = begin; i != end && i - begin <= mask; ++i) {
+                const LogRecord *record = records[i & mask].get();
+                if (record != nullptr) {
+                    writeAll(fd, record->text.data(), record->text.size());
+                }
+            }
+        }
+        fsync(fd);
+    }
+
+    // Возвращаем прежний обработчик и повторяем сигнал: процесс завершится так, как завершился бы без нас
+    sigaction(signal, &previousActions[signal], nullptr);
+    raise(signal);
+}
+
+}  // namespace
+
+CrashSlot *acquireCrashSlot(uint64_t owner, const RecordPtr *records, size_t capacity) {
+    for (auto &slot : crashSlots) {
+        uint64_t expected = 0;
+        if (slot.owner.load(std::memory_order_relaxed) == 0 &&
+            slot.owner.compare_exchange_strong(expected, owner, std::memory_order_acq_rel)) {
+            slot.begin.store(0, std::memory_order_relaxed);
+            slot.end.store(0, std::memory_order_relaxed);
+            slot.mask.store(capacity - 1, std::memory_order_relaxed);
+            slot.records.store(records, std::memory_order_release);
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void releaseCrashSlot(CrashSlot *slot) {
+    if (slot == nullptr) {
+        return;
+    }
+    slot->records.store(nullptr, std::memory_order_release);
+    slot->end.store(0, std::memory_order_relaxed);
+    slot->begin.store(0, std::memory_order_relaxed);
+    slot->owner.store(0, std::memory_order_release);
+}
+
+CrashBuffer *acquireCrashBuffer(const char *data) {
+    for (auto &buffer : crashBuffers) {
+        const char *expected = nullptr;
+        if (buffer.data.load(std::memory_order_relaxed) == nullptr &&
+            buffer.data.compare_exchange_strong(expected, data, std::memory_order_acq_rel)) {
+            return &buffer;
+        }
+    }
+    return nullptr;
+}
+
+void releaseCrashBuffer(CrashBuffer *buffer) {
+    if (buffer == nullptr) {
+        return;
+    }
+    buffer->size.store(0, std::memory_order_release);
+    buffer->fd.store(-1, std::memory_order_relaxed);
+    buffer->data.store(nullptr, std::memory_order_release);
+}
+
+void installAlternateSignalStack() {
+    if (alternateStack.memory != nullptr) {
+        return;
+    }
+    stack_t current{};
+    if (sigaltstack(nullptr, &current) == 0 && (current.ss_flags & SS_DISABLE) == 0) {
+        return;  // Стек уже поставлен кем-то другим
+    }
+
+    void *memory = mmap(nullptr, alternateStackSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK,
+                        -1, 0);
+    if (memory == MAP_FAILED) {
+        return;
+    }
+    stack_t stack{};
+    stack.ss_sp   = memory;
+    stack.ss_size = alternateStackSize;
+    if (sigaltstack(&stack, nullptr) != 0) {
+        munmap(memory, alternateStackSize);
+        return;
+    }
+    alternateStack.memory = memory;
+}
+
+void installCrashHandler(int fd, uint64_t owner) {
+    installAlternateSignalStack();
+
+    std::lock_guard<std::mutex> lock(installMutex);
+    crashOwner.store(owner, std::memory_order_release);
+    crashFd.store(fd, std::memory_order_release);
+
+    if (handlersInstalled) {
+        return;
+    }
+
+    struct sigaction action {};
+    action.sa_handler = crashSignalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_ONSTACK;
+    for (int signal : crashSignals) {
+        sigaction(signal, &action, &previousActions[signal]);
+    }
+    handlersInstalled = true;
+}
+
+void resetCrashTarget(int fd) {
+    std::lock_guard<std::mutex> lock(installMutex);
+    int expected = fd;
+    crashFd.compare_exchange_strong(expected, -1, std::memory_order_acq_rel);
+}
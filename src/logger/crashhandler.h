@@ -0,0 +1,50 @@
+#ifndef CRASHHANDLER_H
+#define CRASHHANDLER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "record.h"
+
+// Слот реестра записей, которые ещё не дошли до приёмников: кольцо records ёмкостью mask + 1 (степень двойки),
+// невыданные записи — счётчики [begin, end), растущие монотонно. Границы лежат в разных строках кэша:
+// end сдвигает поток-производитель, begin — писатель, обработчик сигнала только читает
+struct alignas(64) CrashSlot {
+    std::atomic<uint64_t>          owner{0};  // id фронтенда логгера, 0 — слот свободен
+    std::atomic<const RecordPtr *> records{nullptr};
+    std::atomic<size_t>            mask{0};
+    alignas(64) std::atomic<size_t> begin{0};
+    alignas(64) std::atomic<size_t> end{0};
+};
+
+// Занимает свободный слот; nullptr, если реестр заполнен (тогда кольцо не видно при аварии)
+CrashSlot *acquireCrashSlot(uint64_t owner, const RecordPtr *records, size_t capacity);
+void       releaseCrashSlot(CrashSlot *slot);
+
+// Буфер приёмника с уже выданными ему записями, которые ещё не дошли до файла: [data, data + size)
+// ложится в fd по смещению offset. Приёмник публикует offset до того, как size станет ненулевым
+struct alignas(64) CrashBuffer {
+    std::atomic<const char *> data{nullptr};  // nullptr — буфер свободен
+    std::atomic<int>          fd{-1};
+    std::atomic<uint64_t>     offset{0};
+    std::atomic<size_t>       size{0};
+};
+
+// Занимает свободную запись реестра буферов; nullptr, если реестр заполнен
+CrashBuffer *acquireCrashBuffer(const char *data);
+void         releaseCrashBuffer(CrashBuffer *buffer);
+
+// Ставит обработчики SIGSEGV, SIGABRT и SIGTERM. При сигнале сначала все буферы приёмников дописываются
+// на свои места через pwrite(2), затем записи из слотов владельца owner (0 — из всех слотов) дописываются
+// в fd через write(2) — в конец файла, за буферами. Без блокировок и выделения памяти,
+// после чего вызывается прежний обработчик
+void installCrashHandler(int fd, uint64_t owner);
+
+// Альтернативный стек сигналов для текущего потока (если у потока его ещё нет). Без него SIGSEGV
+// от переполнения стека не может запустить обработчик. installCrashHandler ставит его вызвавшему потоку,
+// фронтенд буферизации — писателю и потокам-производителям
+void installAlternateSignalStack();
+void resetCrashTarget(int fd);  // Отключает запись в fd, если он всё ещё назначен
+
+#endif  // CRASHHANDLER_H
@@ -1,16 +1,49 @@
 #include "logger.h"
 
-Logger::Logger(const string &filename, const string &level)
-    : defaultLevel(translateLevel(level)), logFile(filename, ios::app) {
-    // Проверяем доступность файла при инициализации
-    if (!logFile) {
-        throw std::runtime_error("Unable to open log file: " + filename);
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+
+namespace {
+
+constexpr size_t timeTextSize = 19;  // "YYYY-MM-DD hh:mm:ss"
+
+// Форматирует время с точностью до секунды. Строка кэшируется в потоке и пересчитывается раз в секунду
+void formatTime(std::chrono::system_clock::time_point now, char (&out)[timeTextSize]) {
+    thread_local std::time_t cachedSecond = -1;
+    thread_local char        cachedText[timeTextSize + 1];
+
+    std::time_t currentTime = std::chrono::system_clock::to_time_t(now);
+    if (currentTime != cachedSecond) {
+        std::tm localTime;
+        localtime_r(&currentTime, &localTime);  // Конвертируем в локальное время
+        std::strftime(cachedText, sizeof(cachedText), "%Y-%m-%d %H:%M:%S", &localTime);
+        cachedSecond = currentTime;
     }
+    std::copy(cachedText, cachedText + timeTextSize, out);
+}
+
+}  // namespace
+
+Logger::Logger(const string &filename, const string &level) : filename(filename), defaultLevel(translateLevel(level)) {
+    // Основной файл журнала; FileSink выбрасывает исключение, если файл недоступен
+    mainSink = std::make_shared<FileSink>(filename);
+    sinks.push_back(mainSink);
 }
 
 Logger::~Logger() {
-    if (logFile.is_open()) {
-        logFile.close();
+    if (crashFd >= 0) {
+        resetCrashTarget(crashFd);
+        ::close(crashFd);
+    }
+    frontEnd.reset();  // Писатель дописывает переданные ему записи до закрытия приёмников
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    for (auto &sink : sinks) {
+        sink->flush();
     }
 }
 
@@ -26,28 +59,162 @@ LogLevel Logger::translateLevel(const string &level) {
     return LogLevel::unknown;
 }
 
-void Logger::saveMessage(const string &message, LogLevel currentLevel) {
+void Logger::saveMessage(std::string_view message, LogLevel currentLevel) {
     if (defaultLevel > currentLevel) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(logMutex);
+    // Форматируем запись один раз, вне блокировки, прямо в блок пула; все приёмники получают один и тот же буфер
+    const auto             now       = std::chrono::system_clock::now();
+    const std::string_view levelName = Leveltostring(currentLevel);
+    char                   timeText[timeTextSize];
+    formatTime(now, timeText);
+
+    // "[" время "][" уровень "] " сообщение "\n"
+    const size_t size = 1 + timeTextSize + 2 + levelName.size() + 2 + message.size() + 1;
+    char        *out;
+    RecordPtr    record = makeRecord(now, currentLevel, size, out);
+
+    *out++ = '[';
+    out    = std::copy(timeText, timeText + timeTextSize, out);
+    *out++ = ']';
+    *out++ = '[';
+    out    = std::copy(levelName.begin(), levelName.end(), out);
+    *out++ = ']';
+    *out++ = ' ';
+    out    = std::copy(message.begin(), message.end(), out);
+    *out   = '\n';
+
+    if (frontEnd) {
+        frontEnd->append(std::move(record));
+        return;
+    }
+    dispatch(std::move(record));
+}
 
-    logFile << "[" << getcurrentTime() << "]" << "[" << Leveltostring(currentLevel) << "]" << message << endl;
+void Logger::dispatch(const RecordPtr &record) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    for (auto &sink : sinks) {
+        if (sink->accepts(record->level)) {
+            sink->write(record);
+        }
+    }
 }
+
 void Logger::changeLogLevel(LogLevel newdefLevel) { defaultLevel = newdefLevel; }
 
+void Logger::enableThreadBuffering(const ThreadBufferOptions &options) {
+    frontEnd = std::make_unique<ThreadBufferFrontEnd>(options, [this](const RecordPtr &record) { dispatch(record); });
+    if (crashFd >= 0) {
+        installCrashHandler(crashFd, frontEnd->getId());
+    }
+}
+
+void Logger::enableCrashHandler() {
+    if (crashFd < 0) {
+        crashFd = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (crashFd < 0) {
+            throw std::runtime_error("Unable to open log file: " + filename);
+        }
+    }
+    // Без буферизации по потокам все записи уже в приёмниках, слоты других логгеров не трогаем
+    installCrashHandler(crashFd, frontEnd ? frontEnd->getId() : UINT64_MAX);
+}
+
+void Logger::enableTimeIndex(uint32_t blockSeconds) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    indexBlockSeconds = blockSeconds;
+    if (uringSink) {
+        uringSink->enableIndex(blockSeconds);
+    } else {
+        mainSink->enableIndex(blockSeconds);
+    }
+}
+
+void Logger::enableIoUringJournal(size_t bufferSize, size_t bufferCount, std::chrono::milliseconds submitInterval) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (uringSink) {
+        return;
+    }
+    // FileSink пишет каждую запись сразу, поэтому файл уже полон; индекс продолжается с последнего блока
+    auto sink = std::make_shared<IoUringFileSink>(filename, mainSink->getMinLevel(), bufferSize, bufferCount, true,
+                                                  submitInterval);
+    sinks.front() = sink;
+    mainSink.reset();
+    if (indexBlockSeconds > 0) {
+        sink->enableIndex(indexBlockSeconds);
+    }
+    uringSink = std::move(sink);
+}
+
+void Logger::syncJournal() {
+    if (frontEnd) {
+        frontEnd->flush();
+    }
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (uringSink) {
+        uringSink->sync();
+    } else {
+        mainSink->flush();
+    }
+}
+
+void Logger::rotateJournal(const string &newFilename) {
+    // Записи, сделанные до ротации, остаются в старом файле
+    if (frontEnd) {
+        frontEnd->flush();
+    }
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (uringSink) {
+        uringSink->rotate(newFilename);
+    } else {
+        auto sink = std::make_shared<FileSink>(newFilename, mainSink->getMinLevel());
+        if (indexBlockSeconds > 0) {
+            sink->enableIndex(indexBlockSeconds);
+        }
+        sinks.front() = sink;
+        mainSink      = std::move(sink);
+    }
+    filename = newFilename;
+
+    // Обработчик сигналов переключается на новый файл до закрытия старого дескриптора
+    if (crashFd >= 0) {
+        const int newCrashFd = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (newCrashFd < 0) {
+            throw std::runtime_error("Unable to open log file: " + filename);
+        }
+        installCrashHandler(newCrashFd, frontEnd ? frontEnd->getId() : UINT64_MAX);
+        resetCrashTarget(crashFd);
+        ::close(crashFd);
+        crashFd = newCrashFd;
+    }
+}
+
+void Logger::flush() {
+    if (frontEnd) {
+        frontEnd->flush();
+    }
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    for (auto &sink : sinks) {
+        sink->flush();
+    }
+}
+
+void Logger::addSink(std::shared_ptr<LogSink> sink) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    sinks.push_back(std::move(sink));
+}
+
 string Logger::getcurrentTime() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t currentTime = std::chrono::system_clock::to_time_t(now);  // Конвертируем в локальное время
-    std::tm *localTime = std::localtime(&currentTime);
-    // Форматируем время в строку
-    std::ostringstream oss;
-    oss << std::put_time(localTime, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+    char timeText[timeTextSize];
+    formatTime(std::chrono::system_clock::now(), timeText);
+    return string(timeText, timeTextSize);
 }
 
-string Logger::Leveltostring(LogLevel currentLevel) {
+std::string_view Logger::Leveltostring(LogLevel currentLevel) {
     switch (currentLevel) {
         case LogLevel::info:
             return "INFO";
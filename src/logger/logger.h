@@ -10,16 +10,18 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 
-using namespace std;
+#include "crashhandler.h"
+#include "record.h"
+#include "recordpool.h"
+#include "sink.h"
+#include "threadbuffer.h"
+#include "uringsink.h"
 
-enum LogLevel {
-    unknown = 0,  // неизвестное
-    info    = 1,  // информация
-    warning = 2,  // предупреждение
-    error   = 3   // ошибка
-};
+using namespace std;
 
 class Logger {
    public:
@@ -27,12 +29,23 @@ class Logger {
 
     ~Logger();  // деструктор
 
-    void            saveMessage(const string &message, LogLevel currentLevel);
-    void            changeLogLevel(LogLevel newdefLevel);
-    string          Leveltostring(LogLevel currentLevel);
-    bool            hasError() const;
-    static LogLevel translateLevel(const string &level);
-    string          getcurrentTime();
+    void             saveMessage(std::string_view message, LogLevel currentLevel);
+    void             changeLogLevel(LogLevel newdefLevel);
+    void             addSink(std::shared_ptr<LogSink> sink);  // Дополнительный приёмник со своим уровнем
+    void             enableThreadBuffering(const ThreadBufferOptions &options = ThreadBufferOptions());
+    void             flush();  // Дописывает всё, что накоплено в буферах, и сбрасывает приёмники
+    void             enableCrashHandler();  // При SIGSEGV/SIGABRT/SIGTERM дописать накопленное в файл журнала
+    void             enableTimeIndex(uint32_t blockSeconds = 10);  // Индекс "<файл>.idx" для быстрого поиска
+    // Основной файл журнала пишется через IoUringFileSink вместо FileSink; включается до начала записи.
+    // Неполный буфер уходит в файл не реже раза в submitInterval (0 — только при заполнении и flush)
+    void enableIoUringJournal(size_t bufferSize = 64 * 1024, size_t bufferCount = 4,
+                              std::chrono::milliseconds submitInterval = std::chrono::milliseconds(100));
+    void             syncJournal();                             // Дописать накопленное и fsync основного файла
+    void             rotateJournal(const string &newFilename);  // Продолжить основной журнал в новом файле
+    std::string_view Leveltostring(LogLevel currentLevel);  // Имена уровней статические, без выделения памяти
+    bool             hasError() const;
+    static LogLevel  translateLevel(const string &level);
+    string           getcurrentTime();
 
    private:
     string   filename;
@@ -40,12 +53,18 @@ class Logger {
     // std::ofstream logFile;
     // std::mutex logMutex;
 
-    std::queue<std::string> logQueue;      // Очередь сообщений для записи
-    std::mutex              logMutex;      // Мьютекс для защиты очереди
-    std::condition_variable logCondition;  // Условная переменная
-    std::ofstream           logFile;       // Файловый поток для записи логов
-    bool                    isRunning;     // Флаг работы логгера
-    std::thread             logThread;     // Фоновый поток для записи логов
+    std::mutex                            logMutex;  // Мьютекс для защиты приёмников
+    std::vector<std::shared_ptr<LogSink>> sinks;     // Приёмники записей, защищены logMutex
+    std::shared_ptr<FileSink>             mainSink;   // Основной файл журнала, первый в sinks
+    std::shared_ptr<IoUringFileSink>      uringSink;  // Вместо mainSink после enableIoUringJournal
+    uint32_t                              indexBlockSeconds = 0;  // 0 — индекс основного файла не ведётся
+
+    // Буферизация по потокам с фоновым писателем; включается до начала записи
+    std::unique_ptr<ThreadBufferFrontEnd> frontEnd;
+
+    int crashFd = -1;  // Отдельный дескриптор файла журнала для обработчика сигналов
+
+    void dispatch(const RecordPtr &record);  // Раздача записи приёмникам
 
     bool errorOccurred = false;
 };
@@ -0,0 +1,94 @@
+#include "logindex.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char indexMagic[8] = "LOGIDX1";
+
+}  // namespace
+
+std::string indexPathFor(const std::string &logPath) { return logPath + ".idx"; }
+
+LogIndexWriter::LogIndexWriter(const std::string &indexPath, uint32_t blockSeconds)
+    : blockSeconds(blockSeconds == 0 ? 1 : blockSeconds) {
+    fd = ::open(indexPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open index file: " + indexPath);
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        st.st_size = 0;
+    }
+
+    IndexHeader header{};
+    if (static_cast<size_t>(st.st_size) >= sizeof(header) && pread(fd, &header, sizeof(header), 0) == sizeof(header) &&
+        std::memcmp(header.magic, indexMagic, sizeof(indexMagic)) == 0 && header.entrySize == sizeof(IndexEntry)) {
+        // Продолжаем существующий индекс с его длиной блока
+        this->blockSeconds = header.blockSeconds;
+        entryCount         = (st.st_size - sizeof(header)) / sizeof(IndexEntry);
+        if (entryCount > 0 && pread(fd, &current, sizeof(current),
+                                    sizeof(header) + (entryCount - 1) * sizeof(IndexEntry)) != sizeof(current)) {
+            entryCount = 0;
+        }
+    } else {
+        std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+        header.blockSeconds = this->blockSeconds;
+        header.entrySize    = sizeof(IndexEntry);
+        if (ftruncate(fd, 0) != 0 || pwrite(fd, &header, sizeof(header), 0) != sizeof(header)) {
+            ::close(fd);
+            throw std::runtime_error("Unable to write index file: " + indexPath);
+        }
+    }
+}
+
+LogIndexWriter::~LogIndexWriter() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+uint32_t LogIndexWriter::getBlockSeconds() const { return blockSeconds; }
+
+void LogIndexWriter::writeCurrent() {
+    const off_t position = sizeof(IndexHeader) + (entryCount - 1) * sizeof(IndexEntry);
+    // Индекс — подсказка для поиска; ошибка записи не должна мешать журналу
+    if (pwrite(fd, &current, sizeof(current), position) != sizeof(current)) {
+        return;
+    }
+}
+
+void LogIndexWriter::add(std::time_t time, LogLevel level, uint64_t offset) {
+    const int64_t  blockStart = static_cast<int64_t>(time) - static_cast<int64_t>(time) % blockSeconds;
+    const uint32_t levelBit   = 1u << level;
+
+    if (entryCount == 0 || blockStart > current.startTime) {
+        current = IndexEntry{blockStart, offset, levelBit, 0};
+        ++entryCount;
+        writeCurrent();
+        return;
+    }
+
+    // Запоздавшая запись (из окна переупорядочивания) остаётся в текущем блоке, а блок запоминает,
+    // насколько раньше своего начала он может содержать записи
+    const int64_t late    = current.startTime - static_cast<int64_t>(time);
+    bool          changed = false;
+    if (late > static_cast<int64_t>(current.lateSeconds)) {
+        current.lateSeconds = static_cast<uint32_t>(std::min<int64_t>(late, UINT32_MAX));
+        changed             = true;
+    }
+    if ((current.levelMask & levelBit) == 0) {
+        current.levelMask |= levelBit;
+        changed = true;
+    }
+    if (changed) {
+        writeCurrent();
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef LOGINDEX_H
+#define LOGINDEX_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+#include "record.h"
+
+// Разреженный индекс журнала по времени (файл "<журнал>.idx"):
+// заголовок, затем по одной записи на каждый блок из blockSeconds секунд
+
+struct IndexHeader {
+    char     magic[8];      // "LOGIDX1"
+    uint32_t blockSeconds;  // Длина блока
+    uint32_t entrySize;     // sizeof(IndexEntry)
+};
+
+// Блок содержит записи со временем из [startTime - lateSeconds, startTime + blockSeconds):
+// запоздавшие записи (из окна переупорядочивания) попадают в текущий блок, а не в блок своего времени
+struct IndexEntry {
+    int64_t  startTime;    // Начало блока, секунды Unix, кратно blockSeconds
+    uint64_t offset;       // Смещение первой записи блока в журнале
+    uint32_t levelMask;    // Бит (1 << LogLevel) для каждого уровня, встреченного в блоке
+    uint32_t lateSeconds;  // На сколько самая ранняя запись блока раньше startTime (0 — запоздавших нет)
+};
+
+std::string indexPathFor(const std::string &logPath);
+
+// Дописывает индекс по мере записи журнала. Существующий индекс продолжается с последнего блока
+class LogIndexWriter {
+   public:
+    LogIndexWriter(const std::string &indexPath, uint32_t blockSeconds);
+    ~LogIndexWriter();
+
+    LogIndexWriter(const LogIndexWriter &)            = delete;
+    LogIndexWriter &operator=(const LogIndexWriter &) = delete;
+
+    // Запись уровня level со временем time начинается в журнале со смещения offset
+    void     add(std::time_t time, LogLevel level, uint64_t offset);
+    uint32_t getBlockSeconds() const;
+
+   private:
+    void writeCurrent();
+
+    int        fd = -1;
+    uint32_t   blockSeconds;
+    uint64_t   entryCount = 0;  // Записано блоков, включая текущий
+    IndexEntry current{};
+};
+
+#endif  // LOGINDEX_H
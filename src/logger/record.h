@@ -0,0 +1,26 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <chrono>
+#include <memory>
+#include <string_view>
+
+enum LogLevel {
+    unknown = 0,  // неизвестное
+    info    = 1,  // информация
+    warning = 2,  // предупреждение
+    error   = 3   // ошибка
+};
+
+// Запись журнала. Форматируется один раз и раздаётся всем приёмникам.
+// Создаётся через makeRecord (recordpool.h): запись и её текст лежат в одном блоке пула
+struct LogRecord {
+    std::chrono::system_clock::time_point time;   // Время получения сообщения
+    LogLevel                              level;  // Уровень важности
+    std::string_view                      text;   // Готовая строка "[время][УРОВЕНЬ] сообщение\n" в том же блоке
+};
+
+// Общий буфер записи с подсчётом ссылок
+using RecordPtr = std::shared_ptr<const LogRecord>;
+
+#endif  // RECORD_H
@@ -0,0 +1,202 @@
+#include "recordpool.h"
+
+#include <atomic>
+#include <new>
+
+namespace {
+
+constexpr size_t maxPools   = 4;    // Сколько пулов умеет кэшировать поток
+constexpr size_t cacheBatch = 32;   // Блоков за одно обращение к общему списку
+constexpr size_t cacheLimit = 128;  // Больше этого поток отдаёт лишнее обратно
+
+std::atomic<size_t> nextSlot{0};
+
+// Свободные блоки, закреплённые за текущим потоком
+struct ThreadCache {
+    struct Entry {
+        BlockPool            *pool  = nullptr;
+        BlockPool::FreeBlock *head  = nullptr;
+        size_t                count = 0;
+    };
+    Entry entries[maxPools];
+
+    ~ThreadCache() {
+        for (auto &entry : entries) {
+            if (entry.pool != nullptr && entry.count > 0) {
+                entry.pool->returnBatch(entry.head, entry.count);
+            }
+        }
+    }
+};
+
+thread_local ThreadCache threadCache;
+
+// Удаляет запись и возвращает её блок туда, откуда он взят
+struct RecordDeleter {
+    bool pooled;
+
+    void operator()(LogRecord *record) const {
+        record->~LogRecord();
+        if (pooled) {
+            recordPool().deallocate(record);
+        } else {
+            ::operator delete(record);
+        }
+    }
+};
+
+// Аллокатор управляющего блока shared_ptr
+template <class T>
+struct ControlBlockAllocator {
+    using value_type = T;
+
+    ControlBlockAllocator() = default;
+    template <class U>
+    ControlBlockAllocator(const ControlBlockAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        if (n * sizeof(T) <= controlBlockPool().getBlockSize()) {
+            return static_cast<T *>(controlBlockPool().allocate());
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *pointer, size_t n) {
+        if (n * sizeof(T) <= controlBlockPool().getBlockSize()) {
+            controlBlockPool().deallocate(pointer);
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+    template <class U>
+    bool operator==(const ControlBlockAllocator<U> &) const {
+        return true;
+    }
+    template <class U>
+    bool operator!=(const ControlBlockAllocator<U> &) const {
+        return false;
+    }
+};
+
+}  // namespace
+
+BlockPool::BlockPool(size_t blockSize, size_t blocksPerChunk)
+    : slot(nextSlot.fetch_add(1)), blockSize(blockSize), blocksPerChunk(blocksPerChunk) {
+    // Блоки выровнены как результат operator new
+    const size_t alignment = alignof(std::max_align_t);
+    if (this->blockSize < sizeof(FreeBlock)) {
+        this->blockSize = sizeof(FreeBlock);
+    }
+    this->blockSize = (this->blockSize + alignment - 1) / alignment * alignment;
+    if (this->blocksPerChunk == 0) {
+        this->blocksPerChunk = 1;
+    }
+}
+
+size_t BlockPool::getBlockSize() const { return blockSize; }
+
+void BlockPool::grow() {
+    // Куски не освобождаются: пул живёт до конца процесса
+    char *chunk = static_cast<char *>(::operator new(blockSize * blocksPerChunk));
+    for (size_t i = 0; i < blocksPerChunk; ++i) {
+        auto *block = reinterpret_cast<FreeBlock *>(chunk + i * blockSize);
+        block->next = freeList;
+        freeList    = block;
+    }
+}
+
+BlockPool::FreeBlock *BlockPool::takeBatch(size_t count, size_t &taken) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    FreeBlock                  *head = nullptr;
+    for (taken = 0; taken < count; ++taken) {
+        if (freeList == nullptr) {
+            grow();
+        }
+        FreeBlock *block = freeList;
+        freeList         = block->next;
+        block->next      = head;
+        head             = block;
+    }
+    return head;
+}
+
+void BlockPool::returnBatch(FreeBlock *head, size_t count) {
+    if (head == nullptr || count == 0) {
+        return;
+    }
+    FreeBlock *tail = head;
+    while (tail->next != nullptr) {
+        tail = tail->next;
+    }
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    tail->next = freeList;
+    freeList   = head;
+}
+
+void *BlockPool::allocate() {
+    if (slot >= maxPools) {
+        size_t taken;
+        return takeBatch(1, taken);
+    }
+
+    auto &entry = threadCache.entries[slot];
+    entry.pool  = this;
+    if (entry.count == 0) {
+        entry.head = takeBatch(cacheBatch, entry.count);
+    }
+    FreeBlock *block = entry.head;
+    entry.head       = block->next;
+    --entry.count;
+    return block;
+}
+
+void BlockPool::deallocate(void *pointer) {
+    auto *block = static_cast<FreeBlock *>(pointer);
+    if (slot >= maxPools) {
+        block->next = nullptr;
+        returnBatch(block, 1);
+        return;
+    }
+
+    auto &entry = threadCache.entries[slot];
+    entry.pool  = this;
+    block->next = entry.head;
+    entry.head  = block;
+    ++entry.count;
+
+    // Поток, который только освобождает (например, писатель), не копит блоки бесконечно
+    if (entry.count > cacheLimit) {
+        FreeBlock *keepTail = entry.head;
+        for (size_t i = 1; i < cacheBatch; ++i) {
+            keepTail = keepTail->next;
+        }
+        FreeBlock *spill = keepTail->next;
+        keepTail->next   = nullptr;
+        returnBatch(spill, entry.count - cacheBatch);
+        entry.count = cacheBatch;
+    }
+}
+
+BlockPool &recordPool() {
+    static BlockPool *pool = new BlockPool(512, 256);
+    return *pool;
+}
+
+BlockPool &controlBlockPool() {
+    static BlockPool *pool = new BlockPool(64, 1024);
+    return *pool;
+}
+
+RecordPtr makeRecord(std::chrono::system_clock::time_point time, LogLevel level, size_t textSize, char *&text) {
+    const size_t total  = sizeof(LogRecord) + textSize;
+    const bool   pooled = total <= recordPool().getBlockSize();  // Длинные записи идут в обычную кучу
+    void        *memory = pooled ? recordPool().allocate() : ::operator new(total);
+
+    auto *record = new (memory) LogRecord{time, level, std::string_view()};
+    text         = reinterpret_cast<char *>(record + 1);
+    record->text = std::string_view(text, textSize);
+
+    return RecordPtr(record, RecordDeleter{pooled}, ControlBlockAllocator<LogRecord>());
+}
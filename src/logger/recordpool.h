@@ -0,0 +1,47 @@
+#ifndef RECORDPOOL_H
+#define RECORDPOOL_H
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+#include "record.h"
+
+// Пул блоков фиксированного размера. Блоки берутся и возвращаются через кэш текущего потока,
+// общий список свободных блоков трогается пачками
+class BlockPool {
+   public:
+    BlockPool(size_t blockSize, size_t blocksPerChunk);
+
+    BlockPool(const BlockPool &)            = delete;
+    BlockPool &operator=(const BlockPool &) = delete;
+
+    void  *allocate();
+    void   deallocate(void *block);
+    size_t getBlockSize() const;
+
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    FreeBlock *takeBatch(size_t count, size_t &taken);    // Из общего списка, при нехватке выделяет новый кусок
+    void       returnBatch(FreeBlock *head, size_t count);  // В общий список
+
+   private:
+    void grow();  // Под мьютексом
+
+    size_t     slot;  // Номер пула в кэше потока
+    size_t     blockSize;
+    size_t     blocksPerChunk;
+    std::mutex poolMutex;
+    FreeBlock *freeList = nullptr;
+};
+
+// Пулы для записей журнала и для управляющих блоков shared_ptr. Живут до конца процесса
+BlockPool &recordPool();
+BlockPool &controlBlockPool();
+
+// Создаёт запись с местом под текст длиной textSize. Текст заполняется через text до первого использования записи
+RecordPtr makeRecord(std::chrono::system_clock::time_point time, LogLevel level, size_t textSize, char *&text);
+
+#endif  // RECORDPOOL_H
@@ -0,0 +1,201 @@
+#include "sink.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+LogSink::LogSink(LogLevel minLevel) : minLevel(minLevel) {}
+
+bool LogSink::accepts(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+
+void LogSink::setMinLevel(LogLevel newMinLevel) { minLevel = newMinLevel; }
+
+LogLevel LogSink::getMinLevel() const { return minLevel; }
+
+FileSink::FileSink(const std::string &filename, LogLevel minLevel)
+    : LogSink(minLevel), filename(filename), logFile(filename, std::ios::app) {
+    // Проверяем доступность файла при инициализации
+    if (!logFile) {
+        throw std::runtime_error("Unable to open log file: " + filename);
+    }
+}
+
+FileSink::~FileSink() {
+    if (logFile.is_open()) {
+        logFile.close();
+    }
+}
+
+void FileSink::write(const RecordPtr &record) {
+    if (index) {
+        index->add(std::chrono::system_clock::to_time_t(record->time), record->level, offset);
+        offset += record->text.size();
+    }
+    logFile.write(record->text.data(), record->text.size());
+    logFile.flush();
+}
+
+void FileSink::enableIndex(uint32_t blockSeconds) {
+    logFile.flush();
+    struct stat st;
+    offset = stat(filename.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+    index  = std::make_unique<LogIndexWriter>(indexPathFor(filename), blockSeconds);
+}
+
+void FileSink::flush() { logFile.flush(); }
+
+StderrSink::StderrSink(LogLevel minLevel) : LogSink(minLevel) {}
+
+void StderrSink::write(const RecordPtr &record) { std::cerr.write(record->text.data(), record->text.size()); }
+
+MmapFileSink::MmapFileSink(const std::string &filename, LogLevel minLevel, size_t chunkSize)
+    : LogSink(minLevel), chunkSize(chunkSize) {
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open log file: " + filename);
+    }
+
+    // Продолжаем с конца уже существующего файла
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to stat log file: " + filename);
+    }
+    used = static_cast<size_t>(st.st_size);
+    remap(used + chunkSize);
+}
+
+MmapFileSink::~MmapFileSink() {
+    if (mapped != nullptr) {
+        munmap(mapped, capacity);
+    }
+    if (fd >= 0) {
+        // Отрезаем незаполненный хвост последнего блока
+        if (ftruncate(fd, static_cast<off_t>(used)) != 0) {
+            std::perror("MmapFileSink: ftruncate");
+        }
+        ::close(fd);
+    }
+}
+
+void MmapFileSink::remap(size_t newCapacity) {
+    if (ftruncate(fd, static_cast<off_t>(newCapacity)) != 0) {
+        throw std::runtime_error("Unable to grow mmap log file");
+    }
+    if (mapped != nullptr) {
+        munmap(mapped, capacity);
+    }
+
+    void *region = mmap(nullptr, newCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        mapped   = nullptr;
+        capacity = 0;
+        throw std::runtime_error("Unable to mmap log file");
+    }
+    mapped   = static_cast<char *>(region);
+    capacity = newCapacity;
+}
+
+void MmapFileSink::write(const RecordPtr &record) {
+    const std::string_view text = record->text;
+    if (used + text.size() > capacity) {
+        remap(std::max(capacity + chunkSize, used + text.size() + chunkSize));
+    }
+    std::memcpy(mapped + used, text.data(), text.size());
+    used += text.size();
+}
+
+void MmapFileSink::flush() {
+    if (mapped != nullptr) {
+        msync(mapped, capacity, MS_ASYNC);
+    }
+}
+
+UnixSocketSink::UnixSocketSink(const std::string &socketPath, LogLevel minLevel) : LogSink(minLevel) {
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Socket path is too long: " + socketPath);
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        throw std::runtime_error("Unable to connect to log socket: " + socketPath);
+    }
+}
+
+UnixSocketSink::~UnixSocketSink() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+void UnixSocketSink::write(const RecordPtr &record) {
+    // Приоритет syslog: facility user (1) * 8 + severity
+    int severity;
+    switch (record->level) {
+        case LogLevel::error:
+            severity = 3;
+            break;
+        case LogLevel::warning:
+            severity = 4;
+            break;
+        default:
+            severity = 6;
+            break;
+    }
+
+    char prefix[8];
+    int  prefixLen = std::snprintf(prefix, sizeof(prefix), "<%d>", 8 + severity);
+
+    // Перевод строки в датаграмме не нужен
+    size_t textLen = record->text.size();
+    if (textLen > 0 && record->text[textLen - 1] == '\n') {
+        --textLen;
+    }
+
+    iovec parts[2];
+    parts[0].iov_base = prefix;
+    parts[0].iov_len  = static_cast<size_t>(prefixLen);
+    parts[1].iov_base = const_cast<char *>(record->text.data());
+    parts[1].iov_len  = textLen;
+
+    msghdr msg{};
+    msg.msg_iov    = parts;
+    msg.msg_iovlen = 2;
+    sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);  // Потеря датаграммы не должна блокировать логгер
+}
+
+RingSink::RingSink(size_t capacity, LogLevel minLevel) : LogSink(minLevel), ring(std::max<size_t>(capacity, 1)) {}
+
+void RingSink::write(const RecordPtr &record) {
+    std::lock_guard<std::mutex> lock(ringMutex);
+    ring[next] = record;
+    next       = (next + 1) % ring.size();
+    count      = std::min(count + 1, ring.size());
+}
+
+std::vector<RecordPtr> RingSink::snapshot() const {
+    std::lock_guard<std::mutex> lock(ringMutex);
+    std::vector<RecordPtr>      result;
+    result.reserve(count);
+
+    size_t start = (next + ring.size() - count) % ring.size();
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(ring[(start + i) % ring.size()]);
+    }
+    return result;
+}
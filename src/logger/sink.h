@@ -0,0 +1,113 @@
+#ifndef SINK_H
+#define SINK_H
+
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "logindex.h"
+#include "record.h"
+
+// Базовый приёмник записей журнала со своим минимальным уровнем
+class LogSink {
+   public:
+    explicit LogSink(LogLevel minLevel = LogLevel::unknown);
+    virtual ~LogSink() = default;
+
+    bool     accepts(LogLevel level) const;
+    void     setMinLevel(LogLevel newMinLevel);
+    LogLevel getMinLevel() const;
+
+    // Вызывается логгером последовательно, под его мьютексом
+    virtual void write(const RecordPtr &record) = 0;
+    virtual void flush() {}
+
+   private:
+    std::atomic<LogLevel> minLevel;
+};
+
+// Запись в текстовый файл (дозапись)
+class FileSink : public LogSink {
+   public:
+    FileSink(const std::string &filename, LogLevel minLevel = LogLevel::unknown);
+    ~FileSink() override;
+
+    void write(const RecordPtr &record) override;
+    void flush() override;
+
+    // Вести разреженный индекс по времени в "<файл>.idx" (см. logindex.h) начиная с текущего конца файла
+    void enableIndex(uint32_t blockSeconds);
+
+   private:
+    std::string                     filename;
+    std::ofstream                   logFile;
+    std::unique_ptr<LogIndexWriter> index;
+    uint64_t                        offset = 0;  // Размер файла; ведётся только вместе с индексом
+};
+
+// Вывод в стандартный поток ошибок
+class StderrSink : public LogSink {
+   public:
+    explicit StderrSink(LogLevel minLevel = LogLevel::unknown);
+
+    void write(const RecordPtr &record) override;
+};
+
+// Запись в файл через отображение в память. Файл растёт блоками по chunkSize байт,
+// при закрытии обрезается до реально записанного размера
+class MmapFileSink : public LogSink {
+   public:
+    MmapFileSink(const std::string &filename, LogLevel minLevel = LogLevel::unknown, size_t chunkSize = 1 << 20);
+    ~MmapFileSink() override;
+
+    MmapFileSink(const MmapFileSink &)            = delete;
+    MmapFileSink &operator=(const MmapFileSink &) = delete;
+
+    void write(const RecordPtr &record) override;
+    void flush() override;
+
+   private:
+    void remap(size_t newCapacity);
+
+    int    fd       = -1;
+    char  *mapped   = nullptr;  // Отображённая область файла
+    size_t capacity = 0;        // Размер отображения
+    size_t used     = 0;        // Записано байт
+    size_t chunkSize;
+};
+
+// Отправка записей в Unix-сокет в формате syslog (по умолчанию /dev/log)
+class UnixSocketSink : public LogSink {
+   public:
+    explicit UnixSocketSink(const std::string &socketPath = "/dev/log", LogLevel minLevel = LogLevel::unknown);
+    ~UnixSocketSink() override;
+
+    UnixSocketSink(const UnixSocketSink &)            = delete;
+    UnixSocketSink &operator=(const UnixSocketSink &) = delete;
+
+    void write(const RecordPtr &record) override;
+
+   private:
+    int fd = -1;
+};
+
+// Кольцевой буфер последних записей в памяти. Хранит ссылки на записи, без копирования текста
+class RingSink : public LogSink {
+   public:
+    explicit RingSink(size_t capacity, LogLevel minLevel = LogLevel::unknown);
+
+    void                   write(const RecordPtr &record) override;
+    std::vector<RecordPtr> snapshot() const;  // Записи от старой к новой
+
+   private:
+    mutable std::mutex     ringMutex;
+    std::vector<RecordPtr> ring;
+    size_t                 next  = 0;  // Позиция для следующей записи
+    size_t                 count = 0;  // Сколько слотов занято
+};
+
+#endif  // SINK_H
@@ -0,0 +1,351 @@
+#include "threadbuffer.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "crashhandler.h"
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Кольцо записей одного потока: поток-производитель дописывает в конец, писатель забирает с начала.
+// Счётчики лежат в слоте реестра аварийной записи, поэтому невыданные записи видны обработчику сигналов
+// без лишних сохранений. Запись — одно обычное сохранение end, без блокировок и атомарных RMW
+class ProducerRing {
+   public:
+    // Кольцо без слота реестра не создаётся: его записи пропали бы при аварии. nullptr — реестр заполнен
+    static std::shared_ptr<ProducerRing> create(size_t capacity, uint64_t owner) {
+        auto ring  = std::make_shared<ProducerRing>(capacity);
+        ring->slot = acquireCrashSlot(owner, ring->records.get(), capacity);
+        return ring->slot != nullptr ? ring : nullptr;
+    }
+
+    explicit ProducerRing(size_t capacity) : records(new RecordPtr[capacity]), mask(capacity - 1) {}
+
+    ~ProducerRing() { releaseSlot(); }
+
+    ProducerRing(const ProducerRing &)            = delete;
+    ProducerRing &operator=(const ProducerRing &) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    // Сторона производителя. false — кольцо полно, запись остаётся у вызывающего
+    bool tryPush(RecordPtr &record) {
+        const size_t end = slot->end.load(std::memory_order_relaxed);
+        if (end - cachedBegin > mask) {
+            cachedBegin = slot->begin.load(std::memory_order_acquire);
+            wakeupSent  = false;
+            if (end - cachedBegin > mask) {
+                return false;
+            }
+        }
+        records[end & mask] = std::move(record);
+        slot->end.store(end + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Кольцо заполнено наполовину по последнему известному производителю началу. Срабатывает один раз
+    // до следующего обновления cachedBegin, то есть не чаще раза за оборот кольца
+    bool needsWriter() {
+        if (wakeupSent || slot->end.load(std::memory_order_relaxed) - cachedBegin <= mask / 2) {
+            return false;
+        }
+        wakeupSent = true;
+        return true;
+    }
+
+    bool hasSpace() const {
+        return slot->end.load(std::memory_order_relaxed) - slot->begin.load(std::memory_order_acquire) <= mask;
+    }
+
+    // Сторона писателя: выдаются только записи, видимые на момент snapshot()
+    void   snapshot() { visibleEnd = slot->end.load(std::memory_order_acquire); }
+    size_t pending() const { return visibleEnd - slot->begin.load(std::memory_order_relaxed); }
+    bool   isEmpty() const {
+        return slot->end.load(std::memory_order_acquire) == slot->begin.load(std::memory_order_relaxed);
+    }
+
+    const RecordPtr &front() const { return records[slot->begin.load(std::memory_order_relaxed) & mask]; }
+
+    void pop() {
+        const size_t begin = slot->begin.load(std::memory_order_relaxed);
+        records[begin & mask].reset();  // До сдвига границы: после него ячейку может занять производитель
+        slot->begin.store(begin + 1, std::memory_order_release);
+    }
+
+    void releaseSlot() {
+        releaseCrashSlot(slot);
+        slot = nullptr;
+    }
+
+    bool finished = false;  // Поток завершился; под Shared::mutex
+
+   private:
+    std::unique_ptr<RecordPtr[]> records;
+    size_t                       mask;
+    CrashSlot                   *slot = nullptr;
+    size_t                       cachedBegin = 0;      // Только производитель
+    bool                         wakeupSent  = false;  // Только производитель
+    size_t                       visibleEnd  = 0;      // Только писатель
+};
+
+}  // namespace
+
+struct ThreadBufferFrontEnd::Shared {
+    uint64_t            id;
+    ThreadBufferOptions options;
+
+    std::mutex              mutex;
+    std::condition_variable wakeup;   // Будит писателя
+    std::condition_variable flushed;  // Будит ожидающих flush()
+    std::condition_variable space;    // Будит производителей, упёршихся в полное кольцо
+
+    std::vector<std::shared_ptr<ProducerRing>> producers;  // Кольца потоков, пишущих в этот фронтенд
+
+    std::atomic<bool> pressure{false};  // Кольцо заполнено наполовину; ставится без мьютекса
+    size_t            waitingProducers = 0;
+    uint64_t          flushRequested   = 0;
+    uint64_t          flushCompleted   = 0;
+    bool              stopping         = false;
+};
+
+namespace {
+
+std::atomic<uint64_t> nextFrontEndId{1};
+
+// Кольцо одного потока для одного фронтенда
+struct ThreadBuffer {
+    uint64_t                                    ownerId;
+    std::weak_ptr<ThreadBufferFrontEnd::Shared> shared;
+    std::shared_ptr<ProducerRing>               ring;  // nullptr — слотов не хватило, поток пишет синхронно
+};
+
+// Все кольца текущего потока. При завершении потока писатель дописывает остатки и убирает кольцо
+struct LocalBuffers {
+    std::vector<ThreadBuffer> buffers;
+
+    ~LocalBuffers() {
+        for (auto &buffer : buffers) {
+            if (!buffer.ring) {
+                continue;
+            }
+            if (auto shared = buffer.shared.lock()) {
+                {
+                    std::lock_guard<std::mutex> lock(shared->mutex);
+                    buffer.ring->finished = true;
+                }
+                shared->wakeup.notify_one();
+            }
+        }
+    }
+
+    ThreadBuffer *find(uint64_t id) {
+        for (auto &buffer : buffers) {
+            if (buffer.ownerId == id) {
+                return &buffer;
+            }
+        }
+        return nullptr;
+    }
+};
+
+thread_local LocalBuffers localBuffers;
+
+ThreadBuffer &localBuffer(const std::shared_ptr<ThreadBufferFrontEnd::Shared> &shared) {
+    if (ThreadBuffer *buffer = localBuffers.find(shared->id)) {
+        return *buffer;
+    }
+
+    // Первая запись потока в этот фронтенд: заодно убираем кольца уничтоженных логгеров
+    auto &buffers = localBuffers.buffers;
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                 [](const ThreadBuffer &buffer) { return buffer.shared.expired(); }),
+                  buffers.end());
+
+    installAlternateSignalStack();  // Обработчик аварийной записи сработает и при переполнении стека потока
+
+    ThreadBuffer buffer;
+    buffer.ownerId = shared->id;
+    buffer.shared  = shared;
+    buffer.ring    = ProducerRing::create(roundUpToPowerOfTwo(shared->options.bufferRecords), shared->id);
+    if (buffer.ring) {
+        {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            shared->producers.push_back(buffer.ring);
+        }
+        shared->wakeup.notify_one();  // Писатель начинает просыпаться по таймеру
+    }
+    buffers.push_back(std::move(buffer));
+    return buffers.back();
+}
+
+}  // namespace
+
+ThreadBufferFrontEnd::ThreadBufferFrontEnd(const ThreadBufferOptions &options, Dispatch dispatch)
+    : shared(std::make_shared<Shared>()), dispatch(std::move(dispatch)) {
+    shared->id      = nextFrontEndId.fetch_add(1);
+    shared->options = options;
+    if (shared->options.bufferRecords < 2) {
+        shared->options.bufferRecords = 2;
+    }
+    writer = std::thread(&ThreadBufferFrontEnd::writerLoop, this);
+}
+
+ThreadBufferFrontEnd::~ThreadBufferFrontEnd() {
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->stopping = true;
+    }
+    shared->wakeup.notify_one();
+    writer.join();
+}
+
+uint64_t ThreadBufferFrontEnd::getId() const { return shared->id; }
+
+void ThreadBufferFrontEnd::append(RecordPtr record) {
+    ProducerRing *buffer = localBuffer(shared).ring.get();
+    if (buffer == nullptr) {  // Реестр аварийной записи заполнен: пишем сразу, как без буферизации
+        dispatch(record);
+        return;
+    }
+
+    ProducerRing &ring = *buffer;
+    if (ring.tryPush(record)) {
+        // Кольцо заполнено наполовину: будим писателя, не дожидаясь его таймера. Флаг — обычное сохранение,
+        // а notify_one без ожидающих не делает системного вызова
+        if (ring.needsWriter()) {
+            shared->pressure.store(true, std::memory_order_relaxed);
+            shared->wakeup.notify_one();
+        }
+        return;
+    }
+
+    // Кольцо полно: ждём, пока писатель освободит место
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    ++shared->waitingProducers;
+    shared->wakeup.notify_one();
+    shared->space.wait(lock, [&]() { return ring.hasSpace() || shared->stopping; });
+    --shared->waitingProducers;
+    lock.unlock();
+
+    if (!ring.tryPush(record)) {  // Логгер уничтожается: пишем напрямую
+        dispatch(record);
+    }
+}
+
+void ThreadBufferFrontEnd::flush() {
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    uint64_t                     ticket = ++shared->flushRequested;
+    shared->wakeup.notify_one();
+    shared->flushed.wait(lock, [&]() { return shared->flushCompleted >= ticket; });
+}
+
+void ThreadBufferFrontEnd::writerLoop() {
+    installAlternateSignalStack();
+
+    std::vector<std::shared_ptr<ProducerRing>> rings;  // Копия списка колец для обхода без общей блокировки
+    std::vector<ProducerRing *>                heads;  // Куча колец по времени первой невыданной записи
+    const auto                                 window   = shared->options.reorderWindow;
+    const auto                                 interval = shared->options.flushInterval;
+    auto later = [](const ProducerRing *a, const ProducerRing *b) { return a->front()->time > b->front()->time; };
+
+    bool                                  holding = false;  // Есть записи, придержанные окном
+    std::chrono::system_clock::time_point oldestHeld;
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    while (true) {
+        auto ready = [&]() {
+            return shared->stopping || shared->flushRequested != shared->flushCompleted ||
+                   shared->waitingProducers > 0 || shared->pressure.load(std::memory_order_relaxed);
+        };
+        if (holding) {
+            // Просыпаемся, когда придержанная запись выйдет из окна, но не реже раза в flushInterval
+            auto release = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               oldestHeld + window - std::chrono::system_clock::now()) +
+                           std::chrono::milliseconds(1);
+            shared->wakeup.wait_for(lock, std::max(std::chrono::milliseconds(1), std::min(release, interval)), ready);
+        } else if (!shared->producers.empty()) {
+            shared->wakeup.wait_for(lock, interval, ready);
+        } else {
+            shared->wakeup.wait(lock, [&]() { return ready() || !shared->producers.empty(); });
+        }
+        shared->pressure.store(false, std::memory_order_relaxed);
+
+        const bool     stopping = shared->stopping;
+        const bool     drainAll = stopping || shared->flushRequested != shared->flushCompleted;
+        const uint64_t ticket   = shared->flushRequested;
+
+        // Кольца завершившихся потоков, из которых всё выдано, больше не нужны
+        auto &producers = shared->producers;
+        producers.erase(std::remove_if(producers.begin(), producers.end(),
+                                       [](const std::shared_ptr<ProducerRing> &ring) {
+                                           return ring->finished && ring->isEmpty();
+                                       }),
+                        producers.end());
+        rings.assign(producers.begin(), producers.end());
+        lock.unlock();
+
+        // Горизонт берём до снимков колец: запись старше горизонта к моменту снимка уже опубликована,
+        // поэтому порядок не зависит от того, как давно писатель обходил кольца
+        const auto scanStart = std::chrono::system_clock::now();
+        bool       pressured = false;
+        heads.clear();
+        for (auto &ring : rings) {
+            ring->snapshot();
+            if (ring->pending() > 0) {
+                heads.push_back(ring.get());
+            }
+            if (ring->pending() * 2 >= ring->capacity()) {
+                pressured = true;
+            }
+        }
+        std::make_heap(heads.begin(), heads.end(), later);
+
+        // Наполовину заполненное кольцо не ждёт окна, иначе производитель упрётся в полное кольцо:
+        // выдаём всё, что записано до начала обхода
+        const auto horizon = drainAll ? std::chrono::system_clock::time_point::max()
+                             : pressured ? scanStart
+                                         : scanStart - window;
+        holding = false;
+        while (!heads.empty()) {
+            std::pop_heap(heads.begin(), heads.end(), later);
+            ProducerRing *ring = heads.back();
+            if (ring->front()->time > horizon) {
+                holding    = true;
+                oldestHeld = ring->front()->time;
+                break;
+            }
+            dispatch(ring->front());
+            ring->pop();
+            if (ring->pending() > 0) {
+                std::push_heap(heads.begin(), heads.end(), later);
+            } else {
+                heads.pop_back();
+            }
+        }
+        rings.clear();
+
+        lock.lock();
+        if (shared->waitingProducers > 0) {
+            shared->space.notify_all();
+        }
+        if (drainAll) {
+            shared->flushCompleted = ticket;
+            shared->flushed.notify_all();
+        }
+        if (stopping) {
+            for (auto &ring : shared->producers) {
+                ring->releaseSlot();  // Массивы колец переживут логгер в потоках, но при аварии уже не нужны
+            }
+            shared->space.notify_all();
+            break;
+        }
+    }
+}
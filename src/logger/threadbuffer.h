@@ -0,0 +1,51 @@
+#ifndef THREADBUFFER_H
+#define THREADBUFFER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "record.h"
+
+// Параметры режима буферизации по потокам
+struct ThreadBufferOptions {
+    size_t                    bufferRecords = 256;                            // Ёмкость кольца потока (до степени двойки)
+    std::chrono::milliseconds flushInterval = std::chrono::milliseconds(50);  // Период обхода колец писателем
+    std::chrono::milliseconds reorderWindow = std::chrono::milliseconds(20);  // Окно восстановления порядка
+};
+
+// Фронтенд логгера: каждый поток-производитель пишет в собственное кольцо записей, писатель
+// обходит кольца раз в flushInterval (или раньше, когда кольцо заполнено наполовину) и сливает
+// их головы по времени записи. Полное кольцо останавливает производителя до освобождения места
+class ThreadBufferFrontEnd {
+   public:
+    using Dispatch = std::function<void(const RecordPtr &)>;
+
+    ThreadBufferFrontEnd(const ThreadBufferOptions &options, Dispatch dispatch);
+    ~ThreadBufferFrontEnd();  // Дописывает записи всех колец и останавливает писателя
+
+    ThreadBufferFrontEnd(const ThreadBufferFrontEnd &)            = delete;
+    ThreadBufferFrontEnd &operator=(const ThreadBufferFrontEnd &) = delete;
+
+    void append(RecordPtr record);  // Вызывается из потока-производителя; без блокировок, пока кольцо не полно
+    void flush();                   // Ждёт, пока писатель выдаст все уже записанные в кольца записи
+
+    uint64_t getId() const;  // Метка слотов реестра аварийной записи (crashhandler.h)
+
+    struct Shared;  // Состояние, общее для производителей и писателя
+
+   private:
+    void writerLoop();
+
+    std::shared_ptr<Shared> shared;
+    Dispatch                dispatch;
+    std::thread             writer;
+};
+
+#endif  // THREADBUFFER_H
@@ -0,0 +1,431 @@
+#include "uringsink.h"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint64_t fsyncUserData = UINT64_MAX;  // Метка завершения fsync
+
+int ioUringSetup(unsigned entries, io_uring_params *params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    int result;
+    do {
+        result = static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+    } while (result < 0 && errno == EINTR);
+    return result;
+}
+
+int ioUringRegister(int ringFd, unsigned opcode, const void *arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ringFd, opcode, arg, count));
+}
+
+void pwriteAll(int fd, const char *data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t written = pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+}
+
+}  // namespace
+
+// Отображённые в память очереди io_uring
+struct IoUringFileSink::Ring {
+    int fd = -1;
+
+    void  *sqPointer = nullptr;
+    size_t sqSize    = 0;
+    void  *cqPointer = nullptr;
+    size_t cqSize    = 0;
+    void  *sqeArea   = nullptr;
+    size_t sqeSize   = 0;
+
+    unsigned      *sqTail  = nullptr;
+    unsigned      *sqMask  = nullptr;
+    unsigned      *sqArray = nullptr;
+    io_uring_sqe  *sqes    = nullptr;
+    unsigned      *cqHead  = nullptr;
+    unsigned      *cqTail  = nullptr;
+    unsigned      *cqMask  = nullptr;
+    io_uring_cqe  *cqes    = nullptr;
+
+    bool init(unsigned entries) {
+        io_uring_params params{};
+        fd = ioUringSetup(entries, &params);
+        if (fd < 0) {
+            return false;
+        }
+
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMmap) {
+            sqSize = cqSize = std::max(sqSize, cqSize);
+        }
+
+        sqPointer = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqPointer == MAP_FAILED) {
+            sqPointer = nullptr;
+            return false;
+        }
+        if (singleMmap) {
+            cqPointer = sqPointer;
+        } else {
+            cqPointer = mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cqPointer == MAP_FAILED) {
+                cqPointer = nullptr;
+                return false;
+            }
+        }
+        sqeSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqeArea = mmap(nullptr, sqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqeArea == MAP_FAILED) {
+            sqeArea = nullptr;
+            return false;
+        }
+
+        char *sq = static_cast<char *>(sqPointer);
+        char *cq = static_cast<char *>(cqPointer);
+        sqTail   = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask   = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray  = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        sqes     = static_cast<io_uring_sqe *>(sqeArea);
+        cqHead   = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail   = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask   = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes     = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    ~Ring() {
+        if (sqeArea != nullptr) {
+            munmap(sqeArea, sqeSize);
+        }
+        if (cqPointer != nullptr && cqPointer != sqPointer) {
+            munmap(cqPointer, cqSize);
+        }
+        if (sqPointer != nullptr) {
+            munmap(sqPointer, sqSize);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    // Слот очереди отправки; публикуется вызовом submit()
+    io_uring_sqe *nextSqe() {
+        const unsigned tail  = *sqTail;
+        const unsigned index = tail & *sqMask;
+        io_uring_sqe  *sqe   = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        return sqe;
+    }
+
+    bool submit() {
+        __atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+        return ioUringEnter(fd, 1, 0, 0) == 1;
+    }
+};
+
+IoUringFileSink::IoUringFileSink(const std::string &filename, LogLevel minLevel, size_t bufferSize,
+                                 size_t bufferCount, bool tryIoUring, std::chrono::milliseconds submitInterval)
+    : LogSink(minLevel), bufferSize(std::max<size_t>(bufferSize, 4096)), bufferCount(std::max<size_t>(bufferCount, 2)),
+      slots(this->bufferCount), submitInterval(submitInterval) {
+    openFile(filename);
+
+    // Буферы выровнены по странице: так их можно зарегистрировать в ядре один раз
+    void *area = mmap(nullptr, this->bufferSize * this->bufferCount, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Unable to allocate io_uring buffers");
+    }
+    bufferArea = static_cast<char *>(area);
+
+    if (tryIoUring) {
+        // Буферы в полёте плюс fsync
+        unsigned entries = 1;
+        while (entries < this->bufferCount + 1) {
+            entries <<= 1;
+        }
+
+        ring = std::make_unique<Ring>();
+        std::vector<iovec> buffers(this->bufferCount);
+        for (size_t i = 0; i < this->bufferCount; ++i) {
+            buffers[i].iov_base = bufferData(i);
+            buffers[i].iov_len  = this->bufferSize;
+        }
+        if (!ring->init(entries) ||
+            ioUringRegister(ring->fd, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) != 0) {
+            ring.reset();  // Запасной путь: те же буферы через pwrite
+        }
+    }
+
+    for (size_t i = 0; i < this->bufferCount; ++i) {
+        slots[i].crash = acquireCrashBuffer(bufferData(i));
+    }
+    publishFile();
+
+    if (submitInterval.count() > 0) {
+        timer = std::thread(&IoUringFileSink::timerLoop, this);
+    }
+}
+
+IoUringFileSink::~IoUringFileSink() {
+    if (timer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(sinkMutex);
+            stopping = true;
+        }
+        timerWakeup.notify_one();
+        timer.join();
+    }
+
+    syncLocked();
+    for (auto &slot : slots) {
+        releaseCrashBuffer(slot.crash);
+    }
+    ring.reset();
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (bufferArea != nullptr) {
+        munmap(bufferArea, bufferSize * bufferCount);
+    }
+}
+
+void IoUringFileSink::openFile(const std::string &name) {
+    // Без O_APPEND: смещения задаём сами, чтобы буферы в полёте не перемешались
+    fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open log file: " + name);
+    }
+    struct stat st;
+    offset   = fstat(fd, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+    filename = name;
+    if (indexBlockSeconds > 0) {
+        index = std::make_unique<LogIndexWriter>(indexPathFor(filename), indexBlockSeconds);
+    }
+}
+
+bool IoUringFileSink::usesIoUring() const {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    return ring != nullptr;
+}
+
+void IoUringFileSink::enableIndex(uint32_t blockSeconds) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    indexBlockSeconds = blockSeconds;
+    index             = std::make_unique<LogIndexWriter>(indexPathFor(filename), blockSeconds);
+}
+
+char *IoUringFileSink::bufferData(size_t index) { return bufferArea + index * bufferSize; }
+
+void IoUringFileSink::publishFile() {
+    for (auto &slot : slots) {
+        if (slot.crash != nullptr) {
+            slot.crash->fd.store(fd, std::memory_order_release);
+        }
+    }
+    if (slots[current].crash != nullptr) {
+        slots[current].crash->offset.store(offset, std::memory_order_release);
+    }
+}
+
+void IoUringFileSink::publishUsed(size_t index) {
+    if (slots[index].crash != nullptr) {
+        slots[index].crash->size.store(slots[index].used, std::memory_order_release);
+    }
+}
+
+// Неполный буфер не ждёт заполнения дольше submitInterval: редкие записи доходят до файла и без flush()
+void IoUringFileSink::timerLoop() {
+    std::unique_lock<std::mutex> lock(sinkMutex);
+    while (!stopping) {
+        timerWakeup.wait_for(lock, submitInterval, [this]() { return stopping; });
+        if (!stopping) {
+            submitCurrent();
+            reap(false);
+        }
+    }
+}
+
+void IoUringFileSink::write(const RecordPtr &record) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    const char                 *data = record->text.data();
+    size_t                      left = record->text.size();
+
+    // Запись начнётся в файле с offset + заполненная часть текущего буфера
+    if (index) {
+        index->add(std::chrono::system_clock::to_time_t(record->time), record->level, offset + slots[current].used);
+    }
+
+    // Длинная запись разбивается по буферам
+    while (left > 0) {
+        Slot        &slot  = slots[current];
+        const size_t chunk = std::min(left, bufferSize - slot.used);
+        std::memcpy(bufferData(current) + slot.used, data, chunk);
+        slot.used += chunk;
+        data += chunk;
+        left -= chunk;
+        publishUsed(current);
+        if (slot.used == bufferSize) {
+            submitCurrent();
+        }
+    }
+}
+
+void IoUringFileSink::submitCurrent() {
+    Slot &slot = slots[current];
+    if (slot.used == 0) {
+        return;
+    }
+    slot.offset = offset;
+    offset += slot.used;
+
+    bool submitted = false;
+    if (ring) {
+        io_uring_sqe *sqe = ring->nextSqe();
+        sqe->opcode       = IORING_OP_WRITE_FIXED;
+        sqe->fd           = fd;
+        sqe->addr         = reinterpret_cast<uint64_t>(bufferData(current));
+        sqe->len          = static_cast<uint32_t>(slot.used);
+        sqe->off          = slot.offset;
+        sqe->buf_index    = static_cast<uint16_t>(current);
+        sqe->user_data    = current;
+        submitted         = ring->submit();
+    }
+    if (submitted) {
+        slot.inFlight = true;
+        ++inFlight;
+    } else {
+        disableRing();
+        pwriteAll(fd, bufferData(current), slot.used, slot.offset);
+        slot.used = 0;
+        publishUsed(current);
+    }
+
+    // Следующий буфер по кругу; если он ещё в ядре — ждём его завершения
+    current = (current + 1) % bufferCount;
+    reap(false);
+    while (slots[current].inFlight) {
+        reap(true);
+    }
+    if (slots[current].crash != nullptr) {
+        slots[current].crash->offset.store(offset, std::memory_order_release);
+    }
+}
+
+void IoUringFileSink::complete(uint64_t userData, int result) {
+    --inFlight;
+    if (userData == fsyncUserData) {
+        return;
+    }
+
+    Slot &slot = slots[userData];
+    if (result < 0) {
+        // Ядро отказало — дописываем буфер синхронно
+        pwriteAll(fd, bufferData(userData), slot.used, slot.offset);
+    } else if (static_cast<size_t>(result) < slot.used) {
+        pwriteAll(fd, bufferData(userData) + result, slot.used - result, slot.offset + result);
+    }
+    slot.used     = 0;
+    slot.inFlight = false;
+    publishUsed(userData);
+}
+
+void IoUringFileSink::reap(bool wait) {
+    if (!ring || inFlight == 0) {
+        return;
+    }
+
+    unsigned head = *ring->cqHead;
+    if (wait && head == __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+        ioUringEnter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS);
+    }
+
+    const unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const io_uring_cqe &cqe = ring->cqes[head & *ring->cqMask];
+        complete(cqe.user_data, cqe.res);
+        ++head;
+    }
+    __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+}
+
+void IoUringFileSink::waitAll() {
+    while (inFlight > 0) {
+        reap(true);
+    }
+}
+
+void IoUringFileSink::disableRing() {
+    // Неотправленный слот очереди пропадает вместе с кольцом, уже отправленные дожидаемся
+    if (ring) {
+        waitAll();
+        ring.reset();
+    }
+}
+
+void IoUringFileSink::flush() {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    submitCurrent();
+    waitAll();
+}
+
+void IoUringFileSink::sync() {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    syncLocked();
+}
+
+void IoUringFileSink::syncLocked() {
+    submitCurrent();
+    if (ring) {
+        // IO_DRAIN: fsync начнётся только после всех ранее отправленных записей
+        io_uring_sqe *sqe = ring->nextSqe();
+        sqe->opcode       = IORING_OP_FSYNC;
+        sqe->fd           = fd;
+        sqe->flags        = IOSQE_IO_DRAIN;
+        sqe->user_data    = fsyncUserData;
+        if (ring->submit()) {
+            ++inFlight;
+            waitAll();
+            return;
+        }
+        disableRing();
+    }
+    waitAll();
+    fsync(fd);
+}
+
+void IoUringFileSink::rotate(const std::string &newFilename) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    syncLocked();
+    ::close(fd);
+    fd = -1;
+    publishFile();
+    openFile(newFilename);
+    publishFile();
+}
@@ -0,0 +1,87 @@
+#ifndef URINGSINK_H
+#define URINGSINK_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "crashhandler.h"
+#include "sink.h"
+
+// Запись в файл через io_uring (системные вызовы напрямую, без liburing).
+// Записи копируются в один из bufferCount зарегистрированных буферов; заполненный буфер уходит
+// в ядро операцией WRITE_FIXED с явным смещением, пока следующий заполняется. Завершения
+// собираются без ожидания, ждём только когда все буферы в полёте. Неполный буфер отправляется
+// таймером раз в submitInterval, а буферы зарегистрированы в реестре аварийной записи (crashhandler.h).
+// Если io_uring недоступен (старое ядро, seccomp), те же буферы пишутся через pwrite.
+// Все методы берут sinkMutex: sync и rotate можно вызывать из любого потока, пока логгер пишет
+class IoUringFileSink : public LogSink {
+   public:
+    IoUringFileSink(const std::string &filename, LogLevel minLevel = LogLevel::unknown, size_t bufferSize = 64 * 1024,
+                    size_t bufferCount = 4, bool tryIoUring = true,
+                    std::chrono::milliseconds submitInterval = std::chrono::milliseconds(100));  // 0 — без таймера
+    ~IoUringFileSink() override;  // Останавливает таймер, дописывает буферы, fsync, закрывает файл
+
+    IoUringFileSink(const IoUringFileSink &)            = delete;
+    IoUringFileSink &operator=(const IoUringFileSink &) = delete;
+
+    void write(const RecordPtr &record) override;
+    void flush() override;  // Отправляет неполный буфер и ждёт завершения всех записей
+
+    void sync();                                 // flush + fsync, упорядоченный после всех записей
+    void rotate(const std::string &newFilename);  // sync старого файла, затем запись в новый
+    bool usesIoUring() const;
+
+    // Индекс по времени, как у FileSink::enableIndex; после rotate индекс ведётся для нового файла
+    void enableIndex(uint32_t blockSeconds);
+
+   private:
+    struct Ring;
+
+    // Состояние буфера
+    struct Slot {
+        size_t       used     = 0;
+        bool         inFlight = false;
+        uint64_t     offset   = 0;        // Куда в файле пишется буфер
+        CrashBuffer *crash    = nullptr;  // nullptr — реестр аварийной записи был заполнен
+    };
+
+    void openFile(const std::string &name);
+    void timerLoop();
+    void publishFile();               // Дескриптор файла и смещение текущего буфера для обработчика сигналов
+    void publishUsed(size_t index);  // Заполненная часть буфера для обработчика сигналов
+    void syncLocked();
+    void submitCurrent();  // Отправляет текущий буфер и переходит к следующему свободному
+    void reap(bool wait);  // Обрабатывает завершения; wait — дождаться хотя бы одного
+    void waitAll();
+    void disableRing();  // Переход на pwrite после ошибки io_uring_enter
+    void complete(uint64_t userData, int result);
+    char *bufferData(size_t index);
+
+    mutable std::mutex              sinkMutex;  // Защищает всё состояние ниже
+    std::string                     filename;
+    int                             fd     = -1;
+    uint64_t                        offset = 0;  // Смещение для следующего отправляемого буфера
+    std::unique_ptr<LogIndexWriter> index;
+    uint32_t                        indexBlockSeconds = 0;  // 0 — индекс не ведётся
+    size_t                          bufferSize;
+    size_t                          bufferCount;
+    char                           *bufferArea = nullptr;
+    std::vector<Slot>               slots;
+    size_t                          current  = 0;
+    size_t                          inFlight = 0;  // Операций в ядре, включая fsync
+    std::unique_ptr<Ring>           ring;          // nullptr — запасной путь через pwrite
+
+    std::chrono::milliseconds submitInterval;
+    std::condition_variable   timerWakeup;
+    bool                      stopping = false;
+    std::thread               timer;
+};
+
+#endif  // URINGSINK_H
@@ -15,6 +15,7 @@
 std::atomic<bool>        running(true);
 std::mutex               threadsMutex;
 std::vector<std::thread> monitoringThreads;
+bool                     usePressure = false;  // --psi: ждать триггеров PSI вместо опроса
 
 // Функция для выполнения мониторинга
 void monitoringTask(SystemMonitorManager& systemMonitorManager, LogLevel logLevel) {
@@ -63,7 +64,7 @@ void inputThread(Logger& logger) {
         }
 
         SystemMonitor        systemMonitor(logger);
-        SystemMonitorManager systemMonitorManager(systemMonitor, command, logLevel);
+        SystemMonitorManager systemMonitorManager(systemMonitor, command, logLevel, usePressure);
 
         {
             // Создаем новый поток для нового задания
@@ -75,11 +76,17 @@ void inputThread(Logger& logger) {
 
 int main(int argc, char** argv) {
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <filename> <LogLevel>\n";
+        std::cerr << "Usage: " << argv[0] << " <filename> <LogLevel> [--psi]\n";
         return -1;
-    } else if (argc > 3) {
+    } else if (argc > 4) {
         std::cerr << "A lot of arguments!\n";
         return -1;
+    } else if (argc == 4) {
+        if (std::string(argv[3]) != "--psi") {
+            std::cerr << "Unknown option: " << argv[3] << "\n";
+            return -1;
+        }
+        usePressure = true;
     }
 
     const std::string initialLevelStr = argv[2], filename = std::string(argv[1]) + ".txt";
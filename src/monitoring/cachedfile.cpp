@@ -0,0 +1,60 @@
+#include "cachedfile.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+CachedFile::CachedFile(std::string path, int flags) : path(std::move(path)), flags(flags) {}
+
+CachedFile::CachedFile(const CachedFile &other) : path(other.path), flags(other.flags) {}
+
+CachedFile::~CachedFile() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+bool CachedFile::ensureOpen() {
+    if (fd.load(std::memory_order_acquire) >= 0) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(openMutex);
+    if (fd.load(std::memory_order_relaxed) < 0) {
+        fd.store(::open(path.c_str(), flags | O_CLOEXEC, 0644), std::memory_order_release);
+    }
+    return fd.load(std::memory_order_relaxed) >= 0;
+}
+
+ssize_t CachedFile::readAll(char *buffer, size_t size) {
+    if (size == 0 || !ensureOpen()) {
+        return -1;
+    }
+
+    ssize_t total = 0;
+    while (static_cast<size_t>(total) < size - 1) {
+        ssize_t n = pread(fd, buffer + total, size - 1 - total, total);
+        if (n < 0) {
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+    buffer[total] = '\0';
+    return total;
+}
+
+bool CachedFile::appendLine(std::string_view line) {
+    if (!ensureOpen()) {
+        return false;
+    }
+
+    char  newline = '\n';
+    iovec parts[2];
+    parts[0].iov_base = const_cast<char *>(line.data());
+    parts[0].iov_len  = line.size();
+    parts[1].iov_base = &newline;
+    parts[1].iov_len  = 1;
+    return writev(fd, parts, 2) == static_cast<ssize_t>(line.size() + 1);
+}
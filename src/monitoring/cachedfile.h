@@ -0,0 +1,33 @@
+#ifndef CACHEDFILE_H
+#define CACHEDFILE_H
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// Файл, который открывается один раз и дальше читается через pread с начала (для /proc и /sys)
+// или дописывается. Копия получает тот же путь и открывает свой дескриптор при первом обращении.
+// Один объект можно использовать из нескольких потоков: дескриптор открывается ровно один раз
+class CachedFile {
+   public:
+    CachedFile(std::string path, int flags);
+    CachedFile(const CachedFile &other);
+    CachedFile &operator=(const CachedFile &) = delete;
+    ~CachedFile();
+
+    ssize_t readAll(char *buffer, size_t size);  // Читает с начала файла, результат завершается '\0'
+    bool    appendLine(std::string_view line);  // Дописывает строку и перевод строки одним вызовом
+
+   private:
+    bool ensureOpen();
+
+    std::string      path;
+    int              flags;
+    std::atomic<int> fd{-1};
+    std::mutex       openMutex;  // Открытие дескриптора; чтение и запись идут без блокировки
+};
+
+#endif  // CACHEDFILE_H
@@ -0,0 +1,170 @@
+#include "cgroup.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+// Значение "ключ=число" в строке [line, lineEnd); "max" и отсутствие ключа — -1
+long long readKey(const char *line, const char *lineEnd, const char *key) {
+    const size_t keyLength = std::strlen(key);
+    for (const char *field = line; field < lineEnd;) {
+        const char *next = static_cast<const char *>(std::memchr(field, ' ', lineEnd - field));
+        if (next == nullptr) {
+            next = lineEnd;
+        }
+        if (static_cast<size_t>(next - field) > keyLength && std::strncmp(field, key, keyLength) == 0 &&
+            field[keyLength] == '=') {
+            const char *value = field + keyLength + 1;
+            if (std::strncmp(value, "max", 3) == 0) {
+                return -1;
+            }
+            return std::strtoll(value, nullptr, 10);
+        }
+        field = next + 1;
+    }
+    return -1;
+}
+
+}  // namespace
+
+std::string findCgroupDir(const std::string &procCgroup, const std::vector<std::string> &mountPoints) {
+    std::ifstream file(procCgroup);
+    std::string   line;
+    while (std::getline(file, line)) {
+        // В cgroup v2 у процесса одна строка с пустым списком контроллеров
+        if (line.compare(0, 3, "0::") != 0) {
+            continue;
+        }
+        std::string path = line.substr(3);
+        if (path == "/") {
+            path.clear();
+        }
+        for (const std::string &mountPoint : mountPoints) {
+            const std::string dir = mountPoint + path;
+            if (access((dir + "/cgroup.controllers").c_str(), F_OK) == 0) {
+                return dir;
+            }
+        }
+    }
+    return "";
+}
+
+bool inCgroupNamespace(const std::string &procCgroup) {
+    std::ifstream file(procCgroup);
+    std::string   line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, 3, "0::") == 0) {
+            return line == "0::/";
+        }
+    }
+    return false;
+}
+
+CgroupStats::CgroupStats(const std::string &dir)
+    : memoryCurrent(dir + "/memory.current", O_RDONLY),
+      memoryMax(dir + "/memory.max", O_RDONLY),
+      cpuStat(dir + "/cpu.stat", O_RDONLY),
+      cpuMax(dir + "/cpu.max", O_RDONLY),
+      ioStat(dir + "/io.stat", O_RDONLY),
+      ioMax(dir + "/io.max", O_RDONLY),
+      memoryAvailable(!dir.empty() && access((dir + "/memory.current").c_str(), R_OK) == 0),
+      cpuAvailable(!dir.empty() && access((dir + "/cpu.stat").c_str(), R_OK) == 0),
+      ioAvailable(!dir.empty() && access((dir + "/io.stat").c_str(), R_OK) == 0) {}
+
+bool CgroupStats::hasMemory() const { return memoryAvailable; }
+
+bool CgroupStats::hasCpu() const { return cpuAvailable; }
+
+bool CgroupStats::hasIo() const { return ioAvailable; }
+
+bool CgroupStats::hasLimit() {
+    if (readCpuLimit() > 0) {
+        return true;
+    }
+    char text[64];
+    return memoryMax.readAll(text, sizeof(text)) > 0 && std::strncmp(text, "max", 3) != 0;
+}
+
+bool CgroupStats::readMemory(long long &current, long long &limit) {
+    char text[64];
+    if (!memoryAvailable || memoryCurrent.readAll(text, sizeof(text)) <= 0) {
+        return false;
+    }
+    current = std::strtoll(text, nullptr, 10);
+
+    limit = -1;
+    if (memoryMax.readAll(text, sizeof(text)) > 0 && std::strncmp(text, "max", 3) != 0) {
+        limit = std::strtoll(text, nullptr, 10);
+    }
+    return true;
+}
+
+bool CgroupStats::readCpuUsage(long long &usageUsec) {
+    char text[512];
+    if (!cpuAvailable || cpuStat.readAll(text, sizeof(text)) <= 0) {
+        return false;
+    }
+    const char *field = std::strstr(text, "usage_usec ");
+    if (field == nullptr) {
+        return false;
+    }
+    usageUsec = std::strtoll(field + std::strlen("usage_usec "), nullptr, 10);
+    return true;
+}
+
+double CgroupStats::readCpuLimit() {
+    // "$MAX $PERIOD", где $MAX — квота в микросекундах или "max"
+    char text[64];
+    if (cpuMax.readAll(text, sizeof(text)) <= 0 || std::strncmp(text, "max", 3) == 0) {
+        return 0;
+    }
+    char           *end;
+    const long long quota  = std::strtoll(text, &end, 10);
+    const long long period = std::strtoll(end, nullptr, 10);
+    return quota > 0 && period > 0 ? static_cast<double>(quota) / period : 0;
+}
+
+bool CgroupStats::readIo(long long &readBytes, long long &writeBytes) {
+    // Строки вида "8:0 rbytes=... wbytes=... rios=... wios=... dbytes=... dios=..."
+    char text[4096];
+    if (!ioAvailable || ioStat.readAll(text, sizeof(text)) < 0) {
+        return false;
+    }
+    readBytes  = 0;
+    writeBytes = 0;
+    for (const char *line = text; *line != '\0';) {
+        const char *lineEnd = std::strchr(line, '\n');
+        if (lineEnd == nullptr) {
+            lineEnd = line + std::strlen(line);
+        }
+        readBytes += std::max(readKey(line, lineEnd, "rbytes"), 0LL);
+        writeBytes += std::max(readKey(line, lineEnd, "wbytes"), 0LL);
+        line = *lineEnd == '\0' ? lineEnd : lineEnd + 1;
+    }
+    return true;
+}
+
+void CgroupStats::readIoLimit(long long &readBps, long long &writeBps) {
+    // Строки вида "8:16 rbps=2097152 wbps=max riops=max wiops=max"
+    readBps  = 0;
+    writeBps = 0;
+    char text[1024];
+    if (!ioAvailable || ioMax.readAll(text, sizeof(text)) <= 0) {
+        return;
+    }
+    for (const char *line = text; *line != '\0';) {
+        const char *lineEnd = std::strchr(line, '\n');
+        if (lineEnd == nullptr) {
+            lineEnd = line + std::strlen(line);
+        }
+        readBps += std::max(readKey(line, lineEnd, "rbps"), 0LL);
+        writeBps += std::max(readKey(line, lineEnd, "wbps"), 0LL);
+        line = *lineEnd == '\0' ? lineEnd : lineEnd + 1;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef CGROUP_H
+#define CGROUP_H
+
+#include <string>
+#include <vector>
+
+#include "cachedfile.h"
+
+// Каталог cgroup v2 процесса по строке "0::/путь" из procCgroup. Путь ищется под каждой из точек
+// монтирования (в гибридной иерархии cgroup2 смонтирована в /sys/fs/cgroup/unified).
+// Пустая строка — cgroup v2 не найдена
+std::string findCgroupDir(const std::string              &procCgroup = "/proc/self/cgroup",
+                          const std::vector<std::string> &mountPoints = {"/sys/fs/cgroup", "/sys/fs/cgroup/unified"});
+
+// Процесс в своём пространстве имён cgroup: его cgroup видна как корень ("0::/")
+bool inCgroupNamespace(const std::string &procCgroup = "/proc/self/cgroup");
+
+// Когда SystemMonitor считает от cgroup, а не от /proc: automatic — только в пространстве имён cgroup
+// или при конечном лимите cpu.max/memory.max (иначе на любом хосте с systemd проценты были бы от юнита)
+enum class CgroupMode { automatic, always, never };
+
+// Счётчики cgroup v2. Наличие файлов проверяется один раз, дальше чтение через открытые дескрипторы.
+// Лимиты (memory.max, cpu.max, io.max) перечитываются при каждом замере: их меняют на ходу
+class CgroupStats {
+   public:
+    explicit CgroupStats(const std::string &dir);
+
+    bool hasMemory() const;  // memory.current (в корневой cgroup его нет)
+    bool hasCpu() const;     // cpu.stat
+    bool hasIo() const;      // io.stat (если включён контроллер io)
+    bool hasLimit();         // cpu.max или memory.max задают конечный лимит
+
+    bool   readMemory(long long &current, long long &limit);      // limit < 0 — без ограничения ("max")
+    bool   readCpuUsage(long long &usageUsec);                    // usage_usec из cpu.stat
+    double readCpuLimit();                                        // quota / period из cpu.max, 0 — без ограничения
+    bool   readIo(long long &readBytes, long long &writeBytes);   // Суммы rbytes/wbytes по устройствам
+    void   readIoLimit(long long &readBps, long long &writeBps);  // Суммы заданных rbps/wbps из io.max, 0 — нет
+
+   private:
+    CachedFile memoryCurrent;
+    CachedFile memoryMax;
+    CachedFile cpuStat;
+    CachedFile cpuMax;
+    CachedFile ioStat;
+    CachedFile ioMax;
+    bool       memoryAvailable;
+    bool       cpuAvailable;
+    bool       ioAvailable;
+};
+
+#endif  // CGROUP_H
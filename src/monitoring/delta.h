@@ -0,0 +1,27 @@
+#ifndef DELTA_H
+#define DELTA_H
+
+// Скорость роста одного накопительного счётчика относительно другого между соседними замерами:
+// занятое время к общему (/proc/stat), usage_usec к прошедшему времени (cgroup), байты к секундам.
+// Предыдущие значения начинаются с нуля, поэтому первый замер — среднее с момента запуска счётчиков
+class DeltaRate {
+   public:
+    // rate = Δpart / Δwhole; false, если whole не вырос (деление на 0 или сброс счётчика)
+    bool update(double part, double whole, double &rate) {
+        const double deltaPart  = part - prevPart;
+        const double deltaWhole = whole - prevWhole;
+        prevPart  = part;
+        prevWhole = whole;
+        if (deltaWhole <= 0 || deltaPart < 0) {
+            return false;
+        }
+        rate = deltaPart / deltaWhole;
+        return true;
+    }
+
+   private:
+    double prevPart  = 0;
+    double prevWhole = 0;
+};
+
+#endif  // DELTA_H
@@ -1,116 +1,123 @@
 #include "monitoring.h"
 
 #include <sys/statvfs.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
-#include <fstream>
-#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
-#include <sstream>
 #include <thread>
 
-SystemMonitor::SystemMonitor(Logger& logger) : logger(logger) {}
+SystemMonitor::SystemMonitor(Logger& logger, const std::string& cgroupDir, CgroupMode mode)
+    : logger(logger), cgroup(cgroupDir) {
+    // На хосте процесс тоже в cgroup (юнит systemd), но без лимитов её проценты ничего не говорят о машине
+    useCgroup = mode == CgroupMode::always ||
+                (mode == CgroupMode::automatic && (inCgroupNamespace() || cgroup.hasLimit()));
+}
 
 int loadmin;
 int loadmax;
 
-void SystemMonitor::writeToOutputFile(const std::string& message){
-    std::ofstream outFile("output_app.txt", std::ios::app); // Открытие файла для дозаписи
-    if (outFile) {
-        outFile << message << "\n"; // Записываем сообщение в файл
-    }
+void SystemMonitor::writeToOutputFile(std::string_view message){
+    outputFile.appendLine(message); // Дозапись в output_app.txt через открытый дескриптор
 }
 
-void SystemMonitor::monitorCPU(LogLevel userLogLevel) {
-    static long prevIdleTime = 0, prevTotalTime = 0;  // Храним предыдущие значения для расчета
+void SystemMonitor::setReportInterval(std::chrono::milliseconds interval) { reportInterval = interval; }
 
-    // Чтение файла /proc/stat
-    std::ifstream statFile("/proc/stat");
-    if (!statFile) {
-        logger.saveMessage("Failed to open /proc/stat", LogLevel::error);
+void SystemMonitor::report(std::string_view message, double percent, LogLevel userLogLevel, ReportState& state) {
+    // Частые замеры в полосах warning/error не должны повторять в журнале одну и ту же строку
+    const LogLevel level = getLevelfromBound(percent);
+    const auto     now   = std::chrono::steady_clock::now();
+    if (reportInterval.count() > 0 && state.reported && level == state.lastLevel &&
+        now - state.lastReport < reportInterval) {
         return;
     }
+    state.reported   = true;
+    state.lastLevel  = level;
+    state.lastReport = now;
 
-    std::string line;
-    if (std::getline(statFile, line) && line.find("cpu") == 0) {  // Первая строка с "cpu"
-        std::istringstream iss(line);
-        std::string        cpuLabel;
-        long               user, nice, system, idle, iowait, irq, softirq, steal;
-
-        // Считываем значения
-        iss >> cpuLabel >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal;
-
-        // Вычисляем суммарное время простоя и общее время
-        long idleTime  = idle + iowait;  // Idle = idle + iowait
-        long totalTime = user + nice + system + idleTime + irq + softirq + steal;
-
-        // Рассчитываем разницы
-        long deltaIdle  = idleTime - prevIdleTime;
-        long deltaTotal = totalTime - prevTotalTime;
+    getLoadBoundary(userLogLevel);
+    if (loadmin <= percent && percent <= loadmax) {
+        writeToOutputFile(message); // Сохраняем в файл
+    }
 
-        // Обновляем предыдущие значения для следующего цикла
-        prevIdleTime  = idleTime;
-        prevTotalTime = totalTime;
+    logger.saveMessage(message, level);
+}
 
-        // Проверяем, чтобы избежать деления на 0
-        if (deltaTotal > 0) {
-            double cpuLoad = 100.0 * (deltaTotal - deltaIdle) / deltaTotal;
-            cpuLoad        = std::round(cpuLoad * 100) / 100.0;
+// Монотонное время в микросекундах — знаменатель для счётчиков cgroup
+static double monotonicMicros() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<double>(now.tv_sec) * 1e6 + static_cast<double>(now.tv_nsec) / 1e3;
+}
 
-            getLoadBoundary(userLogLevel);
+double SystemMonitor::monitorCPU(LogLevel userLogLevel) {
+    if (useCgroup && cgroup.hasCpu()) {
+        return monitorCgroupCPU(userLogLevel);
+    }
 
-            if (loadmin <= cpuLoad && cpuLoad <= loadmax) {
-                // std::cout << logger.getcurrentTime() << logger.Leveltostring(userLogLevel)
-                //           << " Average CPU Load: " << cpuLoad;
-                std::ostringstream oss;
-                oss << "Average CPU Load: " << cpuLoad << "%";
-                writeToOutputFile(oss.str()); // Сохраняем в файл
-            }
+    // Чтение файла /proc/stat
+    char statText[512];
+    if (statFile.readAll(statText, sizeof(statText)) <= 0) {
+        logger.saveMessage("Failed to open /proc/stat", LogLevel::error);
+        return -1;
+    }
 
-            std::ostringstream oss;
-            oss << std::fixed << std::setprecision(2) << cpuLoad;
+    long user, nice, system, idle, iowait, irq, softirq, steal;
+    // Первая строка с "cpu"
+    if (std::sscanf(statText, "cpu %ld %ld %ld %ld %ld %ld %ld %ld", &user, &nice, &system, &idle, &iowait, &irq,
+                    &softirq, &steal) == 8) {
+        // Вычисляем суммарное время простоя и общее время
+        long idleTime  = idle + iowait;  // Idle = idle + iowait
+        long totalTime = user + nice + system + idleTime + irq + softirq + steal;
 
-            logger.saveMessage(" Average CPU Load: " + oss.str() + "%", getLevelfromBound(cpuLoad));
+        // Доля занятого времени по разнице с предыдущим замером
+        double busyShare;
+        if (hostCpuDelta.update(totalTime - idleTime, totalTime, busyShare)) {
+            double cpuLoad = std::round(busyShare * 10000) / 100.0;
 
+            // Сообщение форматируется один раз и для журнала, и для output_app.txt
+            char message[64];
+            int  length = std::snprintf(message, sizeof(message), "Average CPU Load: %.2f%%", cpuLoad);
+            report(std::string_view(message, static_cast<size_t>(length)), cpuLoad, userLogLevel, cpuReport);
+            return cpuLoad;
         } else {
-            logger.saveMessage(" CPU Load calculation error: deltaTotal <= 0", LogLevel::error);
+            logger.saveMessage("CPU Load calculation error: deltaTotal <= 0", LogLevel::error);
         }
     } else {
-        logger.saveMessage(" Failed to read CPU stats from /proc/stat", LogLevel::error);
+        logger.saveMessage("Failed to read CPU stats from /proc/stat", LogLevel::error);
     }
+    return -1;
 }
 
-void SystemMonitor::monitorMemory(LogLevel userLogLevel) {
-    std::ifstream memFile("/proc/meminfo");
-    if (!memFile) {
-        logger.saveMessage(" Failed to open /proc/meminfo", LogLevel::error);
-        return;
+// Значение поля вида "MemTotal:  16318412 kB" или 0, если поля нет
+static long readMeminfoField(const char* meminfo, const char* label) {
+    const char* field = std::strstr(meminfo, label);
+    if (field == nullptr) {
+        return 0;
     }
+    return std::strtol(field + std::strlen(label), nullptr, 10);
+}
 
-    long memTotal     = 0;
-    long memAvailable = 0;
-
-    std::string line;
-    while (std::getline(memFile, line)) {
-        if (line.find("MemTotal:") == 0) {
-            // Извлекаем значение MemTotal
-            std::istringstream iss(line);
-            std::string        label;
-            iss >> label >> memTotal;
-        } else if (line.find("MemAvailable:") == 0) {
-            // Извлекаем значение MemAvailable
-            std::istringstream iss(line);
-            std::string        label;
-            iss >> label >> memAvailable;
-        }
+double SystemMonitor::monitorMemory(LogLevel userLogLevel) {
+    if (useCgroup && cgroup.hasMemory()) {
+        return monitorCgroupMemory(userLogLevel);
+    }
 
-        // Если оба значения найдены, можно остановить чтение
-        if (memTotal > 0 && memAvailable > 0) {
-            break;
-        }
+    char memText[4096];
+    if (memFile.readAll(memText, sizeof(memText)) <= 0) {
+        logger.saveMessage("Failed to open /proc/meminfo", LogLevel::error);
+        return -1;
     }
 
+    long memTotal     = readMeminfoField(memText, "MemTotal:");
+    long memAvailable = readMeminfoField(memText, "MemAvailable:");
+
     // Если данные успешно извлечены
     if (memTotal > 0 && memAvailable > 0) {
         long   usedMemory   = memTotal - memAvailable;
@@ -118,28 +125,23 @@ void SystemMonitor::monitorMemory(LogLevel userLogLevel) {
         double usedGB       = static_cast<double>(usedMemory) / 1048576.0;  // Перевод в гигабайты
         double usagePercent = (usedGB / totalGB) * 100.0;                   // Процент использования
 
-        getLoadBoundary(userLogLevel);
-        if (loadmin <= usagePercent && usagePercent <= loadmax) {
-            std::ostringstream message;
-            message << "Memory Usage: " << usedGB << " GB used of " << totalGB << " GB total (" << usagePercent << "%)";
-            writeToOutputFile(message.str()); // Сохраняем в файл
-        }
-
         // Формируем понятное сообщение для пользователя
-        std::ostringstream message;
-        message << " Memory Usage: " << usedGB << " GB used of " << totalGB << " GB total (" << usagePercent << "%)";
-
-        logger.saveMessage(message.str(), getLevelfromBound(usagePercent));
+        char message[128];
+        int  length = std::snprintf(message, sizeof(message), "Memory Usage: %g GB used of %g GB total (%g%%)", usedGB,
+                                    totalGB, usagePercent);
+        report(std::string_view(message, static_cast<size_t>(length)), usagePercent, userLogLevel, memoryReport);
+        return usagePercent;
     } else {
-        logger.saveMessage(" Failed to parse memory info", LogLevel::error);
+        logger.saveMessage("Failed to parse memory info", LogLevel::error);
     }
+    return -1;
 }
 
-void SystemMonitor::monitorDisk(LogLevel userLogLevel) {
+double SystemMonitor::monitorDisk(LogLevel userLogLevel) {
     struct statvfs fs;
     if (statvfs("/", &fs) != 0) {
-        logger.saveMessage(" Failed to get disk stats", LogLevel::error);
-        return;
+        logger.saveMessage("Failed to get disk stats", LogLevel::error);
+        return -1;
     }
 
     // Общая емкость и свободное место в гигабайтах
@@ -150,20 +152,130 @@ void SystemMonitor::monitorDisk(LogLevel userLogLevel) {
     // Процент использования
     double usedPercent = (usedGB / totalGB) * 100.0;
 
-    getLoadBoundary(userLogLevel);
-    if (loadmin <= usedPercent && usedPercent <= loadmax) {
-        std::ostringstream oss;
-        oss << "Disk usage for root filesystem: Total space = " << totalGB << " GB, Used = " << usedGB << " GB (" 
-            << usedPercent << "%)";
-        writeToOutputFile(oss.str()); // Сохраняем в файл
+    // Формирование читаемого сообщения
+    char message[160];
+    int  length = std::snprintf(message, sizeof(message),
+                                "Disk usage for root filesystem: Total space = %g GB, Used = %g GB (%g%%)", totalGB,
+                                usedGB, usedPercent);
+    report(std::string_view(message, static_cast<size_t>(length)), usedPercent, userLogLevel, diskReport);
+    return usedPercent;
+}
+
+// Загрузка CPU контейнера: прирост usage_usec к прошедшему времени, умноженному на число доступных CPU
+double SystemMonitor::monitorCgroupCPU(LogLevel userLogLevel) {
+    long long usageUsec;
+    if (!cgroup.readCpuUsage(usageUsec)) {
+        logger.saveMessage("Failed to read cgroup cpu.stat", LogLevel::error);
+        return -1;
     }
 
-    // Формирование читаемого сообщения
-    std::ostringstream oss;
-    oss << " Disk usage for root filesystem: Total space = " << totalGB << " GB, Used = " << usedGB << " GB ("
-        << usedPercent << "%)";
+    // Без квоты в cpu.max доступны все процессоры в сети
+    double cpuLimit = cgroup.readCpuLimit();
+    if (cpuLimit <= 0) {
+        cpuLimit = static_cast<double>(sysconf(_SC_NPROCESSORS_ONLN));
+    }
+
+    double usedCpus;
+    if (!cgroupCpuDelta.update(static_cast<double>(usageUsec), monotonicMicros(), usedCpus) || cpuLimit <= 0) {
+        logger.saveMessage("CPU Load calculation error: no time passed since previous sample", LogLevel::error);
+        return -1;
+    }
+    double cpuLoad = std::round(usedCpus / cpuLimit * 10000) / 100.0;
+
+    char message[96];
+    int  length = std::snprintf(message, sizeof(message), "Average CPU Load: %.2f%% of %g CPUs (cgroup)", cpuLoad,
+                                cpuLimit);
+    report(std::string_view(message, static_cast<size_t>(length)), cpuLoad, userLogLevel, cpuReport);
+    return cpuLoad;
+}
+
+// Память контейнера: memory.current от memory.max, а без лимита — от MemTotal хоста
+double SystemMonitor::monitorCgroupMemory(LogLevel userLogLevel) {
+    long long current, limit;
+    if (!cgroup.readMemory(current, limit)) {
+        logger.saveMessage("Failed to read cgroup memory.current", LogLevel::error);
+        return -1;
+    }
+    if (limit <= 0) {
+        char memText[4096];
+        if (memFile.readAll(memText, sizeof(memText)) > 0) {
+            limit = static_cast<long long>(readMeminfoField(memText, "MemTotal:")) * 1024;
+        }
+    }
+    if (limit <= 0) {
+        logger.saveMessage("Failed to parse memory info", LogLevel::error);
+        return -1;
+    }
+
+    double totalGB      = static_cast<double>(limit) / (1024 * 1024 * 1024);
+    double usedGB       = static_cast<double>(current) / (1024 * 1024 * 1024);
+    double usagePercent = (usedGB / totalGB) * 100.0;
+
+    char message[128];
+    int  length = std::snprintf(message, sizeof(message), "Memory Usage: %g GB used of %g GB cgroup limit (%g%%)",
+                                usedGB, totalGB, usagePercent);
+    report(std::string_view(message, static_cast<size_t>(length)), usagePercent, userLogLevel, memoryReport);
+    return usagePercent;
+}
+
+bool SystemMonitor::hasCgroupIO() const { return useCgroup && cgroup.hasIo(); }
+
+// Пропускная способность диска для контейнера по io.stat; процент — от лимитов io.max, если они заданы
+double SystemMonitor::monitorIO(LogLevel userLogLevel) {
+    if (!hasCgroupIO()) {
+        return -1;
+    }
+    long long readBytes, writeBytes;
+    if (!cgroup.readIo(readBytes, writeBytes)) {
+        logger.saveMessage("Failed to read cgroup io.stat", LogLevel::error);
+        return -1;
+    }
+
+    const double seconds = monotonicMicros() / 1e6;
+    double       readRate, writeRate;
+    if (!ioReadDelta.update(static_cast<double>(readBytes), seconds, readRate) ||
+        !ioWriteDelta.update(static_cast<double>(writeBytes), seconds, writeRate)) {
+        logger.saveMessage("IO calculation error: no time passed since previous sample", LogLevel::error);
+        return -1;
+    }
+
+    long long readBps, writeBps;
+    cgroup.readIoLimit(readBps, writeBps);
+    double percent = 0;
+    if (readBps > 0) {
+        percent = std::max(percent, 100.0 * readRate / readBps);
+    }
+    if (writeBps > 0) {
+        percent = std::max(percent, 100.0 * writeRate / writeBps);
+    }
+
+    char message[128];
+    int  length = std::snprintf(message, sizeof(message), "IO Throughput: read %g MB/s, write %g MB/s (%g%% of io.max)",
+                                readRate / (1024 * 1024), writeRate / (1024 * 1024), percent);
+    report(std::string_view(message, static_cast<size_t>(length)), percent, userLogLevel, ioReport);
+    return percent;
+}
+
+void SystemMonitor::reportPressure(PressureTrigger& trigger, LogLevel userLogLevel) {
+    // Первая строка файла: "some avg10=... avg60=... avg300=... total=..."
+    char stats[256];
+    if (trigger.readStats(stats, sizeof(stats)) <= 0) {
+        stats[0] = '\0';
+    }
+    const char* lineEnd     = std::strchr(stats, '\n');
+    const int   statsLength = lineEnd != nullptr ? static_cast<int>(lineEnd - stats) : static_cast<int>(std::strlen(stats));
+
+    const std::string_view resource = pressureName(trigger.getResource());
+    char                   message[320];
+    int                    length = std::snprintf(message, sizeof(message), "%.*s pressure stall detected: %.*s",
+                                                  static_cast<int>(resource.size()), resource.data(), statsLength, stats);
+    const std::string_view text(message, static_cast<size_t>(length));
+
+    if (userLogLevel == LogLevel::error) {
+        writeToOutputFile(text); // Событие относится к полосе error
+    }
 
-    logger.saveMessage(oss.str(), getLevelfromBound(usedPercent));
+    logger.saveMessage(text, LogLevel::error);
 }
 
 void SystemMonitor::getLoadBoundary(LogLevel userLogLevel) {
@@ -1,22 +1,71 @@
 #ifndef MONITORING_H
 #define MONITORING_H
 
+#include <fcntl.h>
+
+#include <chrono>
 #include <string>
+#include <string_view>
 
 #include <logger/logger.h>
 
+#include "cachedfile.h"
+#include "cgroup.h"
+#include "delta.h"
+#include "pressure.h"
+
 class SystemMonitor {
    public:
-    SystemMonitor(Logger& logger);
-    void monitorCPU(LogLevel userLogLevel);
-    void monitorMemory(LogLevel userLogLevel);
-    void monitorDisk(LogLevel userLogLevel);
+    // cgroupDir — каталог cgroup v2; если в нём есть счётчики и mode это разрешает (решается при создании),
+    // проценты считаются от лимитов контейнера
+    SystemMonitor(Logger& logger, const std::string& cgroupDir = findCgroupDir(),
+                  CgroupMode mode = CgroupMode::automatic);
+    // Сборщики возвращают процент использования или -1, если замер не удался
+    double monitorCPU(LogLevel userLogLevel);
+    double monitorMemory(LogLevel userLogLevel);
+    double monitorDisk(LogLevel userLogLevel);
+    double monitorIO(LogLevel userLogLevel);  // Процент от лимитов io.max по io.stat cgroup; без cgroup — -1
+    bool   hasCgroupIO() const;
+    void reportPressure(PressureTrigger& trigger, LogLevel userLogLevel);  // Срабатывание триггера PSI — ERROR
     void getLoadBoundary(LogLevel userLogLevel);
+    // Замер пишется в журнал и output_app.txt при смене полосы (info/warning/error), а пока значение
+    // остаётся в своей полосе — не чаще раза в interval. 0 (по умолчанию) — каждый замер
+    void setReportInterval(std::chrono::milliseconds interval);
     LogLevel getLevelfromBound(int persant);
 
    private:
     Logger& logger;
-    void writeToOutputFile(const std::string& message);
+    void writeToOutputFile(std::string_view message);
+    // Последняя записанная строка сборщика; каждым сборщиком пользуется один поток
+    struct ReportState {
+        bool                                  reported  = false;
+        LogLevel                              lastLevel = LogLevel::unknown;
+        std::chrono::steady_clock::time_point lastReport;
+    };
+
+    // output_app.txt и журнал с учётом reportInterval
+    void report(std::string_view message, double percent, LogLevel userLogLevel, ReportState& state);
+    double monitorCgroupCPU(LogLevel userLogLevel);
+    double monitorCgroupMemory(LogLevel userLogLevel);
+
+    // Дескрипторы открываются один раз; сообщения собираются в буферах на стеке
+    CachedFile  statFile{"/proc/stat", O_RDONLY};
+    CachedFile  memFile{"/proc/meminfo", O_RDONLY};
+    CachedFile  outputFile{"output_app.txt", O_WRONLY | O_CREAT | O_APPEND};
+    CgroupStats cgroup;
+    bool        useCgroup;  // false — только /proc, даже если счётчики cgroup есть
+
+    // Предыдущие значения счётчиков для расчёта по разнице между замерами
+    DeltaRate hostCpuDelta;
+    DeltaRate cgroupCpuDelta;
+    DeltaRate ioReadDelta;
+    DeltaRate ioWriteDelta;
+
+    std::chrono::milliseconds reportInterval{0};
+    ReportState               cpuReport;
+    ReportState               memoryReport;
+    ReportState               diskReport;
+    ReportState               ioReport;
 };
 
 #endif  // MONITORING_H
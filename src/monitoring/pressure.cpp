@@ -0,0 +1,90 @@
+#include "pressure.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+namespace {
+
+const char *pressurePath(PressureResource resource) {
+    switch (resource) {
+        case PressureResource::cpu:
+            return "/proc/pressure/cpu";
+        case PressureResource::memory:
+            return "/proc/pressure/memory";
+        case PressureResource::io:
+            return "/proc/pressure/io";
+    }
+    return "";
+}
+
+}  // namespace
+
+std::string_view pressureName(PressureResource resource) {
+    switch (resource) {
+        case PressureResource::cpu:
+            return "CPU";
+        case PressureResource::memory:
+            return "Memory";
+        case PressureResource::io:
+            return "IO";
+    }
+    return "Unknown";
+}
+
+PressureTrigger::PressureTrigger(PressureResource resource, const PressureOptions &options) : resource(resource) {
+    using std::chrono::microseconds;
+
+    // Окно, кратное 2 с, — для процессов без CAP_SYS_RESOURCE
+    const microseconds step = std::chrono::seconds(2);
+    const microseconds unprivilegedWindow((options.window.count() + step.count() - 1) / step.count() * step.count());
+
+    if (!registerTrigger(options.stall, options.window) &&
+        (unprivilegedWindow == options.window || !registerTrigger(options.stall, unprivilegedWindow))) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+PressureTrigger::~PressureTrigger() {
+    if (fd >= 0) {
+        ::close(fd);  // Закрытие дескриптора снимает триггер
+    }
+}
+
+bool PressureTrigger::registerTrigger(std::chrono::microseconds stall, std::chrono::microseconds window) {
+    // На одном дескрипторе можно зарегистрировать только один триггер
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    fd = ::open(pressurePath(resource), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    char trigger[64];
+    int  length = std::snprintf(trigger, sizeof(trigger), "some %lld %lld", static_cast<long long>(stall.count()),
+                                static_cast<long long>(window.count()));
+    return ::write(fd, trigger, static_cast<size_t>(length) + 1) == length + 1;
+}
+
+bool PressureTrigger::isAvailable() const { return fd >= 0; }
+
+int PressureTrigger::getFd() const { return fd; }
+
+PressureResource PressureTrigger::getResource() const { return resource; }
+
+ssize_t PressureTrigger::readStats(char *buffer, size_t size) {
+    if (fd < 0 || size == 0) {
+        return -1;
+    }
+    ssize_t length = pread(fd, buffer, size - 1, 0);
+    if (length < 0) {
+        return -1;
+    }
+    buffer[length] = '\0';
+    return length;
+}
@@ -0,0 +1,43 @@
+#ifndef PRESSURE_H
+#define PRESSURE_H
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <string_view>
+
+// Ресурсы, для которых ядро ведёт PSI (/proc/pressure/<ресурс>)
+enum class PressureResource { cpu, memory, io };
+
+// Порог триггера: событие, если за окно window задачи простаивали суммарно дольше stall
+struct PressureOptions {
+    std::chrono::microseconds stall  = std::chrono::milliseconds(100);
+    std::chrono::microseconds window = std::chrono::seconds(1);
+};
+
+// Триггер PSI: ядро помечает дескриптор POLLPRI, когда порог превышен, и POLLERR, если триггер пропал.
+// Без CAP_SYS_RESOURCE ядро принимает только окна, кратные 2 с, — тогда окно округляется вверх
+class PressureTrigger {
+   public:
+    explicit PressureTrigger(PressureResource resource, const PressureOptions &options = PressureOptions());
+    ~PressureTrigger();
+
+    PressureTrigger(const PressureTrigger &)            = delete;
+    PressureTrigger &operator=(const PressureTrigger &) = delete;
+
+    bool             isAvailable() const;  // false — PSI нет (старое ядро, psi=0) или триггер не принят
+    int              getFd() const;        // Для poll() с POLLPRI
+    PressureResource getResource() const;
+
+    ssize_t readStats(char *buffer, size_t size);  // Текущие "some avg10=..."/"full ..." через тот же дескриптор
+
+   private:
+    bool registerTrigger(std::chrono::microseconds stall, std::chrono::microseconds window);
+
+    PressureResource resource;
+    int              fd = -1;
+};
+
+std::string_view pressureName(PressureResource resource);  // "CPU", "Memory", "IO"
+
+#endif  // PRESSURE_H
@@ -1,13 +1,28 @@
 #include "multithreading.h"
 
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <string>
 
 #include "../monitoring/monitoring.h"
 
-SystemMonitorManager::SystemMonitorManager(SystemMonitor& monitor, const std::string& command, LogLevel userLogLevel)
-    : monitor(monitor), running(false), mode(command), userLogLevel(userLogLevel) {}
+SystemMonitorManager::SystemMonitorManager(SystemMonitor& monitor, const std::string& command, LogLevel userLogLevel,
+                                           bool usePressure, const SamplingOptions& sampling)
+    : monitor(monitor),
+      running(false),
+      mode(command),
+      userLogLevel(userLogLevel),
+      usePressure(usePressure),
+      sampling(sampling) {
+    this->monitor.setReportInterval(sampling.reportInterval);  // Своя копия монитора
+}
 
 SystemMonitorManager::~SystemMonitorManager() {
     stopMonitoring();  // Остановка потоков при уничтожении объекта
@@ -19,20 +34,28 @@ void SystemMonitorManager::startMonitoring(LogLevel userLogLevel) {
         return;
     }
 
+    if (usePressure) {
+        stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    }
+
     running = true;  // Устанавливаем флаг
     if (mode == "all") {
-        threads.emplace_back([&]() { monitorCPU(userLogLevel); });
-        threads.emplace_back([&]() { monitorMemory(userLogLevel); });
-        threads.emplace_back([&]() { monitorDisk(userLogLevel); });
+        threads.emplace_back([this, userLogLevel]() { monitorCPU(userLogLevel); });
+        threads.emplace_back([this, userLogLevel]() { monitorMemory(userLogLevel); });
+        threads.emplace_back([this, userLogLevel]() { monitorDisk(userLogLevel); });
     } else if (mode == "cpu") {
-        threads.emplace_back([&]() { monitorCPU(userLogLevel); });
+        threads.emplace_back([this, userLogLevel]() { monitorCPU(userLogLevel); });
     } else if (mode == "memory") {
-        threads.emplace_back([&]() { monitorMemory(userLogLevel); });
+        threads.emplace_back([this, userLogLevel]() { monitorMemory(userLogLevel); });
     } else if (mode == "disk") {
-        threads.emplace_back([&]() { monitorDisk(userLogLevel); });
+        threads.emplace_back([this, userLogLevel]() { monitorDisk(userLogLevel); });
     } else {
         std::cerr << "Invalid mode. Use 'all', 'cpu', 'memory', or 'disk'." << std::endl;
         running = false;
+        if (stopFd >= 0) {
+            ::close(stopFd);
+            stopFd = -1;
+        }
         return;
     }
 }
@@ -43,7 +66,15 @@ void SystemMonitorManager::stopMonitoring() {
         return;
     }
 
-    running = false;  // Устанавливаем флаг остановки
+    {
+        // Под мьютексом: поток не пропустит пробуждение между проверкой флага и ожиданием
+        std::lock_guard<std::mutex> lock(stopMutex);
+        running = false;  // Устанавливаем флаг остановки
+    }
+    stopCondition.notify_all();
+    if (stopFd >= 0) {
+        eventfd_write(stopFd, 1);  // Будим потоки в poll()
+    }
     for (auto& thread : threads) {
         if (thread.joinable()) {
             thread.join();  // Дожидаемся завершения потока
@@ -51,27 +82,148 @@ void SystemMonitorManager::stopMonitoring() {
     }
 
     threads.clear();  // Очищаем список потоков
+    if (stopFd >= 0) {
+        ::close(stopFd);
+        stopFd = -1;
+    }
 }
 
-void SystemMonitorManager::monitorCPU(LogLevel userLogLevel) {
+// Ожидание триггера PSI: поток спит в poll() и просыпается при превышении порога, остановке
+// или, если задан slowPoll, по его сроку
+bool SystemMonitorManager::watchPressure(PressureResource resource, LogLevel userLogLevel, MonitorMetric metric,
+                                         const std::function<double()>& slowPoll) {
+    if (!usePressure || stopFd < 0) {
+        return false;
+    }
+    PressureTrigger trigger(resource);
+    if (!trigger.isAvailable()) {
+        return false;
+    }
+
+    MetricState& state    = metrics[static_cast<size_t>(metric)];
+    auto         nextPoll = std::chrono::steady_clock::now();  // Первый замер — сразу
+    state.samples         = 0;
+
+    pollfd fds[2];
+    fds[0] = {trigger.getFd(), POLLPRI, 0};
+    fds[1] = {stopFd, POLLIN, 0};
     while (running) {
-        monitor.monitorCPU(userLogLevel);
-        std::this_thread::sleep_for(std::chrono::seconds(2));
+        int timeout = -1;
+        if (slowPoll) {
+            // Срок считается от прошлого замера, поэтому частые события PSI его не откладывают
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= nextPoll) {
+                const double value = slowPoll();
+                if (value >= 0) {
+                    state.lastValue = value;
+                }
+                ++state.samples;
+                state.periodMs = sampling.maxPeriod.count();
+                nextPoll       = now + sampling.maxPeriod;
+            }
+            timeout = static_cast<int>(
+                std::chrono::ceil<std::chrono::milliseconds>(nextPoll - std::chrono::steady_clock::now()).count());
+            timeout = std::max(timeout, 0);
+        }
+
+        const int ready = poll(fds, 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (ready == 0) {
+            continue;  // Срок slowPoll
+        }
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+        if (fds[0].revents & POLLERR) {
+            return false;  // Триггер снят ядром (например, удалена cgroup)
+        }
+        if (fds[0].revents & POLLPRI) {
+            monitor.reportPressure(trigger, userLogLevel);
+        }
     }
+    state.periodMs = 0;
+    return true;
+}
+
+// Триггер PSI сообщает о простоях, но не о загрузке: высокая загрузка без простоев тоже должна попасть
+// в журнал и output_app.txt, поэтому между событиями сборщик вызывается раз в maxPeriod
+void SystemMonitorManager::monitorCPU(LogLevel userLogLevel) {
+    auto collect = [this, userLogLevel]() { return monitor.monitorCPU(userLogLevel); };
+    if (watchPressure(PressureResource::cpu, userLogLevel, MonitorMetric::cpu, collect)) {
+        return;
+    }
+    sampleLoop(MonitorMetric::cpu, collect);
 }
 
 void SystemMonitorManager::monitorMemory(LogLevel userLogLevel) {
-    while (running) {
-        monitor.monitorMemory(userLogLevel);
-        std::this_thread::sleep_for(std::chrono::seconds(2));
+    auto collect = [this, userLogLevel]() { return monitor.monitorMemory(userLogLevel); };
+    if (watchPressure(PressureResource::memory, userLogLevel, MonitorMetric::memory, collect)) {
+        return;
     }
+    sampleLoop(MonitorMetric::memory, collect);
 }
 
 void SystemMonitorManager::monitorDisk(LogLevel userLogLevel) {
+    // Триггер IO заменяет опрос io.stat, но не заполненность диска: statvfs остаётся на редком опросе
+    if (watchPressure(PressureResource::io, userLogLevel, MonitorMetric::disk,
+                      [this, userLogLevel]() { return monitor.monitorDisk(userLogLevel); })) {
+        return;
+    }
+    sampleLoop(MonitorMetric::disk, [this, userLogLevel]() {
+        double used = monitor.monitorDisk(userLogLevel);
+        if (monitor.hasCgroupIO()) {
+            used = std::max(used, monitor.monitorIO(userLogLevel));  // Только внутри cgroup с контроллером io
+        }
+        return used;
+    });
+}
+
+void SystemMonitorManager::sampleLoop(MonitorMetric metric, const std::function<double()>& collect) {
+    MetricState&              state    = metrics[static_cast<size_t>(metric)];
+    std::chrono::milliseconds period   = sampling.minPeriod;
+    double                    previous = -1;
+
+    state.samples = 0;
     while (running) {
-        monitor.monitorDisk(userLogLevel);
-        std::this_thread::sleep_for(std::chrono::seconds(2));
+        const double value = collect();
+        period             = nextPeriod(period, value, previous);
+        if (value >= 0) {
+            previous = value;
+        }
+        state.lastValue = previous;
+        ++state.samples;
+        state.periodMs = period.count();
+
+        std::unique_lock<std::mutex> lock(stopMutex);
+        stopCondition.wait_for(lock, period, [this]() { return !running; });
+    }
+    state.periodMs = 0;
+}
+
+std::chrono::milliseconds SystemMonitorManager::nextPeriod(std::chrono::milliseconds period, double value,
+                                                           double previous) {
+    if (value < 0) {
+        return period;  // Замер не удался — период не меняем
+    }
+    // В полосах warning/error опрос остаётся частым; повторяющиеся строки в журнале ограничивает
+    // SystemMonitor::setReportInterval
+    const bool outsideInfo  = monitor.getLevelfromBound(value) != LogLevel::info;
+    const bool fastChanging = previous >= 0 && std::abs(value - previous) >= sampling.changeThreshold;
+    if (outsideInfo || fastChanging) {
+        return sampling.minPeriod;
     }
+    return std::min(period * 2, sampling.maxPeriod);
+}
+
+SamplingStats SystemMonitorManager::getSamplingStats(MonitorMetric metric) const {
+    const MetricState& state = metrics[static_cast<size_t>(metric)];
+    return SamplingStats{sampling.minPeriod, sampling.maxPeriod, std::chrono::milliseconds(state.periodMs.load()),
+                         state.samples.load(), state.lastValue.load()};
 }
 
 // int main() {
@@ -1,34 +1,86 @@
 #ifndef MULTITHREADING_H
 #define MULTITHREADING_H
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <mutex>
 #include <thread>
 #include <vector>
 
 #include <logger/logger.h>
 #include "../monitoring/monitoring.h"
+#include "../monitoring/pressure.h"
+
+enum class MonitorMetric { cpu, memory, disk };
+
+// Адаптивный период опроса: minPeriod, пока значение в полосах warning/error или меняется
+// между замерами больше чем на changeThreshold процентных пунктов; иначе период удваивается до maxPeriod.
+// Запись в журнал отделена от опроса: значение, оставшееся в своей полосе, пишется не чаще reportInterval
+struct SamplingOptions {
+    std::chrono::milliseconds minPeriod       = std::chrono::milliseconds(100);
+    std::chrono::milliseconds maxPeriod       = std::chrono::seconds(30);
+    double                    changeThreshold = 5.0;
+    std::chrono::milliseconds reportInterval  = std::chrono::seconds(2);  // Прежний фиксированный период
+};
+
+// Состояние опроса одной метрики
+struct SamplingStats {
+    std::chrono::milliseconds minPeriod;
+    std::chrono::milliseconds maxPeriod;
+    std::chrono::milliseconds currentPeriod;  // 0 — метрика не опрашивается (ждёт только триггер PSI или не запущена)
+    uint64_t                  samples;        // Замеров с момента запуска
+    double                    lastValue;      // Последний процент, -1 — замеров не было
+};
 
 class SystemMonitorManager {
    public:
     // SystemMonitorManager(Logger& logger);
-    SystemMonitorManager(SystemMonitor& monitor, const std::string& command, LogLevel userLogLevel);
+    // usePressure — ждать триггеров PSI вместо опроса; где PSI нет, остаётся опрос
+    SystemMonitorManager(SystemMonitor& monitor, const std::string& command, LogLevel userLogLevel,
+                         bool usePressure = false, const SamplingOptions& sampling = SamplingOptions());
     ~SystemMonitorManager();
 
     void startMonitoring(LogLevel userLogLevel);
     void stopMonitoring();
 
+    SamplingStats getSamplingStats(MonitorMetric metric) const;
+
    private:
     void monitorCPU(LogLevel userLogLevel);
     void monitorMemory(LogLevel userLogLevel);
     void monitorDisk(LogLevel userLogLevel);
+    // false — перейти на опрос. slowPoll, если задан, вызывается раз в maxPeriod между событиями PSI
+    // (для того, что триггер не покрывает: загрузки CPU и памяти, заполненности диска);
+    // замеры учитываются в metric
+    bool watchPressure(PressureResource resource, LogLevel userLogLevel, MonitorMetric metric,
+                       const std::function<double()>& slowPoll = nullptr);
+
+    // Опрос с адаптивным периодом; collect возвращает процент или -1 при ошибке
+    void sampleLoop(MonitorMetric metric, const std::function<double()>& collect);
+    std::chrono::milliseconds nextPeriod(std::chrono::milliseconds period, double value, double previous);
 
-    SystemMonitor            monitor;
-    std::vector<std::thread> threads;
-    std::atomic<bool>        running;  // Для управления потоками
-    std::string              mode;
-    LogLevel                 userLogLevel;
+    // Поля читаются getSamplingStats из других потоков
+    struct MetricState {
+        std::atomic<int64_t>  periodMs{0};
+        std::atomic<uint64_t> samples{0};
+        std::atomic<double>   lastValue{-1};
+    };
 
+    SystemMonitor              monitor;
+    std::vector<std::thread>   threads;
+    std::atomic<bool>          running;  // Для управления потоками
+    std::string                mode;
+    LogLevel                   userLogLevel;
+    bool                       usePressure;
+    int                        stopFd = -1;  // eventfd: будит потоки, ждущие триггеров PSI
+    SamplingOptions            sampling;
+    std::array<MetricState, 3> metrics;  // По MonitorMetric
+    std::mutex                 stopMutex;
+    std::condition_variable    stopCondition;  // Будит потоки, спящие между замерами
 };
 
 #endif  // MULTITHREADING_H
@@ -0,0 +1,63 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "reader.h"
+
+// Выборка из журнала по времени и уровню:
+//   logreader <файл> [--from "YYYY-MM-DD hh:mm:ss"] [--to "YYYY-MM-DD hh:mm:ss"] [--level warning]
+//             [--block секунды] [--rebuild]
+// Если индекса "<файл>.idx" нет, он строится за один проход и дальше переиспользуется.
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <logfile> [--from \"YYYY-MM-DD hh:mm:ss\"] [--to \"YYYY-MM-DD hh:mm:ss\"]"
+                     " [--level info|warning|error] [--block seconds] [--rebuild]\n";
+        return -1;
+    }
+
+    const std::string logPath = argv[1];
+    LogQuery          query;
+    uint32_t          blockSeconds = 10;
+    bool              rebuild      = false;
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--from" && i + 1 < argc) {
+            query.from = argv[++i];
+        } else if (arg == "--to" && i + 1 < argc) {
+            query.to = argv[++i];
+        } else if (arg == "--level" && i + 1 < argc) {
+            query.minLevel = Logger::translateLevel(argv[++i]);
+            if (query.minLevel == LogLevel::unknown) {
+                std::cerr << "You send unknown level\n";
+                return -1;
+            }
+        } else if (arg == "--block" && i + 1 < argc) {
+            blockSeconds = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--rebuild") {
+            rebuild = true;
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return -1;
+        }
+    }
+
+    try {
+        LogReader reader(logPath);
+        if (rebuild || !reader.loadIndex()) {
+            reader.buildIndex(blockSeconds);
+        }
+
+        size_t matched = reader.query(query, [](std::string_view line) {
+            std::fwrite(line.data(), 1, line.size(), stdout);
+            std::fputc('\n', stdout);
+        });
+        std::cerr << matched << " line(s), " << reader.getBlockCount() << " index block(s)\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include "reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t timeTextSize = 19;  // "YYYY-MM-DD hh:mm:ss"
+
+// Разбор строки времени в секунды Unix (локальное время, как пишет Logger); -1 при ошибке
+std::time_t parseTime(const char *text) {
+    std::tm localTime{};
+    const char *end = strptime(text, "%Y-%m-%d %H:%M:%S", &localTime);
+    if (end == nullptr) {
+        return -1;
+    }
+    localTime.tm_isdst = -1;
+    return std::mktime(&localTime);
+}
+
+LogLevel levelFromTag(std::string_view tag) {
+    if (tag == "INFO") return LogLevel::info;
+    if (tag == "WARNING") return LogLevel::warning;
+    if (tag == "ERROR") return LogLevel::error;
+    return LogLevel::unknown;
+}
+
+// Строка журнала: "[YYYY-MM-DD hh:mm:ss][УРОВЕНЬ] сообщение"
+struct ParsedLine {
+    std::string_view time;
+    LogLevel         level;
+};
+
+bool parseLine(const char *begin, const char *end, ParsedLine &parsed) {
+    if (end - begin < static_cast<std::ptrdiff_t>(timeTextSize + 3) || begin[0] != '[' ||
+        begin[timeTextSize + 1] != ']' || begin[timeTextSize + 2] != '[') {
+        return false;
+    }
+    const char *tagBegin = begin + timeTextSize + 3;
+    const char *tagEnd   = findByte(tagBegin, end, ']');
+    if (tagEnd == end) {
+        return false;
+    }
+    parsed.time  = std::string_view(begin + 1, timeTextSize);
+    parsed.level = levelFromTag(std::string_view(tagBegin, tagEnd - tagBegin));
+    return true;
+}
+
+// Маска уровней не ниже minLevel в формате IndexEntry::levelMask
+uint32_t wantedMask(LogLevel minLevel) { return ~((1u << minLevel) - 1) & 0xFu; }
+
+}  // namespace
+
+const char *findByte(const char *begin, const char *end, char byte) {
+#if defined(__SSE2__)
+    const __m128i pattern = _mm_set1_epi8(byte);
+    while (end - begin >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        const int     mask  = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern));
+        if (mask != 0) {
+            return begin + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        begin += 16;
+    }
+#endif
+    const void *found = std::memchr(begin, byte, end - begin);
+    return found != nullptr ? static_cast<const char *>(found) : end;
+}
+
+LogReader::LogReader(const std::string &logPath) : logPath(logPath) {
+    fd = ::open(logPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open log file: " + logPath);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to stat log file: " + logPath);
+    }
+    size = static_cast<size_t>(st.st_size);
+
+    if (size > 0) {
+        void *region = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (region == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Unable to mmap log file: " + logPath);
+        }
+        data = static_cast<const char *>(region);
+        madvise(region, size, MADV_SEQUENTIAL);
+    }
+}
+
+LogReader::~LogReader() {
+    if (data != nullptr) {
+        munmap(const_cast<char *>(data), size);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+bool LogReader::loadIndex() {
+    entries.clear();
+
+    const std::string indexPath = indexPathFor(logPath);
+    int               indexFd   = ::open(indexPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (indexFd < 0) {
+        return false;
+    }
+
+    IndexHeader header{};
+    struct stat st;
+    bool        valid = fstat(indexFd, &st) == 0 && read(indexFd, &header, sizeof(header)) == sizeof(header) &&
+                 std::strncmp(header.magic, "LOGIDX1", sizeof(header.magic)) == 0 &&
+                 header.entrySize == sizeof(IndexEntry);
+    if (valid) {
+        entries.resize((st.st_size - sizeof(header)) / sizeof(IndexEntry));
+        const ssize_t bytes = static_cast<ssize_t>(entries.size() * sizeof(IndexEntry));
+        valid               = read(indexFd, entries.data(), bytes) == bytes;
+    }
+    ::close(indexFd);
+
+    // Индекс от другого (например, усечённого) файла не используем
+    if (!valid || entries.empty() || entries.back().offset > size || header.blockSeconds == 0) {
+        entries.clear();
+        return false;
+    }
+    blockSeconds = header.blockSeconds;
+    maxLate      = 0;
+    for (const IndexEntry &entry : entries) {
+        maxLate = std::max<int64_t>(maxLate, entry.lateSeconds);
+    }
+    return true;
+}
+
+void LogReader::buildIndex(uint32_t blockSeconds) {
+    const std::string indexPath = indexPathFor(logPath);
+    ::unlink(indexPath.c_str());
+    {
+        LogIndexWriter writer(indexPath, blockSeconds);
+
+        // mktime дорогой: пересчитываем только при смене строки времени
+        std::string_view previousText;
+        std::time_t      previousTime = -1;
+        char             timeText[timeTextSize + 1];
+
+        const char *end = data + size;
+        for (const char *line = data; line < end;) {
+            const char *lineEnd = findByte(line, end, '\n');
+            ParsedLine  parsed;
+            if (parseLine(line, lineEnd, parsed)) {
+                if (parsed.time != previousText) {
+                    std::memcpy(timeText, parsed.time.data(), timeTextSize);
+                    timeText[timeTextSize] = '\0';
+                    previousText           = parsed.time;
+                    previousTime           = parseTime(timeText);
+                }
+                if (previousTime >= 0) {
+                    writer.add(previousTime, parsed.level, static_cast<uint64_t>(line - data));
+                }
+            }
+            line = lineEnd + 1;
+        }
+    }
+    loadIndex();
+}
+
+size_t LogReader::getBlockCount() const { return entries.size(); }
+
+size_t LogReader::scanRange(size_t begin, size_t end, const LogQuery &query,
+                            const std::function<void(std::string_view)> &onLine) const {
+    size_t      matched  = 0;
+    const char *rangeEnd = data + end;
+    for (const char *line = data + begin; line < rangeEnd;) {
+        const char *lineEnd = findByte(line, rangeEnd, '\n');
+        ParsedLine  parsed;
+        // Время фиксированной ширины: лексикографическое сравнение совпадает с хронологическим
+        if (parseLine(line, lineEnd, parsed) && parsed.level >= query.minLevel &&
+            (query.from.empty() || parsed.time >= query.from) && (query.to.empty() || parsed.time <= query.to)) {
+            onLine(std::string_view(line, lineEnd - line));
+            ++matched;
+        }
+        line = lineEnd + 1;
+    }
+    return matched;
+}
+
+size_t LogReader::query(const LogQuery &query, const std::function<void(std::string_view)> &onLine) const {
+    if ((!query.from.empty() && (query.from.size() != timeTextSize || parseTime(query.from.c_str()) < 0)) ||
+        (!query.to.empty() && (query.to.size() != timeTextSize || parseTime(query.to.c_str()) < 0))) {
+        throw std::invalid_argument("Time must be in format YYYY-MM-DD hh:mm:ss");
+    }
+
+    if (size == 0) {
+        return 0;
+    }
+    if (entries.empty()) {
+        return scanRange(0, size, query, onLine);
+    }
+
+    // Начало файла, записанное до включения индекса, просматриваем целиком
+    size_t matched = scanRange(0, entries.front().offset, query, onLine);
+
+    // Записи блока не позже startTime + blockSeconds: двоичный поиск первого блока, который может содержать from
+    size_t first = 0;
+    if (!query.from.empty()) {
+        const int64_t from = static_cast<int64_t>(parseTime(query.from.c_str()));
+        auto it = std::upper_bound(entries.begin(), entries.end(), from - static_cast<int64_t>(blockSeconds),
+                                   [](int64_t time, const IndexEntry &entry) { return time < entry.startTime; });
+        first   = static_cast<size_t>(it - entries.begin());
+    }
+    const int64_t  to   = query.to.empty() ? INT64_MAX : static_cast<int64_t>(parseTime(query.to.c_str()));
+    const uint32_t mask = wantedMask(query.minLevel);
+
+    // Запоздавшие записи лежат в более поздних блоках: идём дальше to на наибольшее опоздание
+    const int64_t lastStart = to > INT64_MAX - maxLate ? INT64_MAX : to + maxLate;
+    for (size_t i = first; i < entries.size() && entries[i].startTime <= lastStart; ++i) {
+        if ((entries[i].levelMask & mask) == 0 || entries[i].startTime - entries[i].lateSeconds > to) {
+            continue;  // В блоке нет записей нужных уровней или все они позже to
+        }
+        const size_t end = i + 1 < entries.size() ? entries[i + 1].offset : size;
+        matched += scanRange(entries[i].offset, end, query, onLine);
+    }
+    return matched;
+}
@@ -0,0 +1,52 @@
+#ifndef READER_H
+#define READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <logger/logger.h>
+
+// Запрос к журналу: записи с уровнем не ниже minLevel в интервале [from, to]
+struct LogQuery {
+    std::string from;                         // "YYYY-MM-DD hh:mm:ss", пусто — без нижней границы
+    std::string to;                           // "YYYY-MM-DD hh:mm:ss", пусто — без верхней границы
+    LogLevel    minLevel = LogLevel::unknown;
+};
+
+// Чтение журнала Logger через отображение в память с поиском по индексу "<журнал>.idx"
+class LogReader {
+   public:
+    explicit LogReader(const std::string &logPath);
+    ~LogReader();
+
+    LogReader(const LogReader &)            = delete;
+    LogReader &operator=(const LogReader &) = delete;
+
+    bool   loadIndex();                          // false, если индекса нет или он не подходит к файлу
+    void   buildIndex(uint32_t blockSeconds);  // Полный проход по журналу с записью индекса
+    size_t getBlockCount() const;
+
+    // Вызывает onLine для каждой подходящей строки (без перевода строки), возвращает их число
+    size_t query(const LogQuery &query, const std::function<void(std::string_view)> &onLine) const;
+
+   private:
+    size_t scanRange(size_t begin, size_t end, const LogQuery &query,
+                     const std::function<void(std::string_view)> &onLine) const;
+
+    std::string             logPath;
+    int                     fd   = -1;
+    const char             *data = nullptr;
+    size_t                  size = 0;
+    std::vector<IndexEntry> entries;
+    uint32_t                blockSeconds = 0;
+    int64_t                 maxLate      = 0;  // Наибольший IndexEntry::lateSeconds
+};
+
+// Первое вхождение byte в [begin, end) или end; SSE2, если доступно
+const char *findByte(const char *begin, const char *end, char byte);
+
+#endif  // READER_H
@@ -1,6 +1,14 @@
 #include <logger/logger.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -10,6 +18,22 @@
 
 #include "../src/monitoring/monitoring.h"
 #include "../src/multithreading/multithreading.h"
+#include "../src/reader/reader.h"
+
+// Счётчик выделений памяти: глобальный operator new подменяется на время тестов
+std::atomic<size_t> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
 
 // Проверка выброса исключения при недоступном файле
 void testLoggerFailsToOpenRestrictedFile() {
@@ -211,6 +235,951 @@ void testLoggerInvalidLogLevel() {
     std::filesystem::remove(logFile);
 }
 
+// Проверка фильтрации уровней по приёмникам
+void testLoggerPerSinkLevels() {
+    const std::string logFile = "sinks_test_log.txt";
+    Logger            logger(logFile, "info");
+
+    auto allRing   = std::make_shared<RingSink>(8);
+    auto errorRing = std::make_shared<RingSink>(8, LogLevel::error);
+    logger.addSink(allRing);
+    logger.addSink(errorRing);
+
+    logger.saveMessage("First info", LogLevel::info);
+    logger.saveMessage("First error", LogLevel::error);
+
+    auto all    = allRing->snapshot();
+    auto errors = errorRing->snapshot();
+    assert(all.size() == 2 && "Ring sink without filter must receive all records");
+    assert(errors.size() == 1 && "Ring sink with error level must receive only errors");
+    assert(errors[0]->text.find("[ERROR] First error") != std::string::npos && "Wrong record in error sink");
+
+    // Одна и та же запись раздаётся всем приёмникам без повторного форматирования
+    assert(all[1].get() == errors[0].get() && "Record was formatted twice for two sinks");
+
+    std::cout << "testLoggerPerSinkLevels passed\n";
+    std::filesystem::remove(logFile);
+}
+
+// Проверка кольцевого буфера: хранятся только последние записи
+void testRingSinkOverwritesOldest() {
+    const std::string logFile = "ring_test_log.txt";
+    Logger            logger(logFile, "info");
+    auto              ring = std::make_shared<RingSink>(3);
+    logger.addSink(ring);
+
+    for (int i = 0; i < 5; ++i) {
+        logger.saveMessage("Ring " + std::to_string(i), LogLevel::info);
+    }
+
+    auto records = ring->snapshot();
+    assert(records.size() == 3 && "Ring sink must keep only the last records");
+    assert(records[0]->text.find("Ring 2") != std::string::npos && "Ring sink lost ordering");
+    assert(records[2]->text.find("Ring 4") != std::string::npos && "Ring sink lost ordering");
+
+    std::cout << "testRingSinkOverwritesOldest passed\n";
+    std::filesystem::remove(logFile);
+}
+
+// Проверка записи через отображение файла в память
+void testMmapFileSink() {
+    const std::string logFile  = "test_log.txt";
+    const std::string mmapFile = "mmap_test_log.txt";
+    {
+        Logger logger(logFile, "info");
+        logger.addSink(std::make_shared<MmapFileSink>(mmapFile, LogLevel::warning, 4096));
+        for (int i = 0; i < 1000; ++i) {
+            logger.saveMessage("Mmap message " + std::to_string(i), i % 2 ? LogLevel::warning : LogLevel::info);
+        }
+    }
+
+    std::ifstream file(mmapFile);
+    int           lineCount = 0;
+    std::string   line;
+    while (std::getline(file, line)) {
+        assert(line.find("[WARNING]") != std::string::npos && "Mmap sink received record below its level");
+        ++lineCount;
+    }
+    assert(lineCount == 500 && "Not all messages were written to mmap sink");
+
+    std::cout << "testMmapFileSink passed\n";
+    std::filesystem::remove(logFile);
+    std::filesystem::remove(mmapFile);
+}
+
+// Проверка буферизации по потокам: все записи доходят, порядок внутри потока сохраняется
+void testLoggerThreadBuffering() {
+    const std::string logFile = "buffered_test_log.txt";
+    {
+        Logger              logger(logFile, "info");
+        ThreadBufferOptions options;
+        options.bufferRecords = 64;
+        logger.enableThreadBuffering(options);
+
+        auto logFunction = [&logger](int id) {
+            for (int i = 0; i < 1000; ++i) {
+                logger.saveMessage("Thread " + std::to_string(id) + " message " + std::to_string(i), LogLevel::info);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int id = 0; id < 4; ++id) {
+            threads.emplace_back(logFunction, id);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        logger.saveMessage("Main thread message", LogLevel::info);
+        logger.flush();
+
+        std::ifstream file(logFile);
+        int           lineCount = 0;
+        int           lastSeen[4] = {-1, -1, -1, -1};
+        std::string   line;
+        while (std::getline(file, line)) {
+            ++lineCount;
+            int id, number;
+            if (std::sscanf(line.c_str(), "%*[^]]][INFO] Thread %d message %d", &id, &number) == 2) {
+                assert(number > lastSeen[id] && "Records of one thread were reordered");
+                lastSeen[id] = number;
+            }
+        }
+        assert(lineCount == 4001 && "Not all buffered messages were logged");
+    }
+
+    std::cout << "testLoggerThreadBuffering passed\n";
+    std::filesystem::remove(logFile);
+}
+
+// Писатель сам забирает записи затихшего потока, придерживает их на время окна и сливает потоки по времени
+void testThreadBufferingMergesAndHandsOffIdle() {
+    const std::string logFile = "merge_test_log.txt";
+    {
+        Logger              logger(logFile, "info");
+        auto                ring = std::make_shared<RingSink>(4096);
+        ThreadBufferOptions options;
+        options.bufferRecords = 1024;
+        options.flushInterval = std::chrono::milliseconds(10);
+        options.reorderWindow = std::chrono::milliseconds(300);
+        logger.addSink(ring);
+        logger.enableThreadBuffering(options);
+
+        // Поток пишет одну запись и засыпает, не вызывая flush
+        std::atomic<bool> done(false);
+        std::thread       idle([&]() {
+            logger.saveMessage("Idle thread message", LogLevel::error);
+            while (!done) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        assert(ring->snapshot().empty() && "Record left the reorder window too early");
+        for (int i = 0; i < 200 && ring->snapshot().empty(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        assert(ring->snapshot().size() == 1 && "Idle thread buffer was not handed off");
+        done = true;
+        idle.join();
+
+        // Записи разных потоков, пришедшие в пределах окна, выдаются в порядке времени
+        std::vector<std::thread> threads;
+        for (int id = 0; id < 4; ++id) {
+            threads.emplace_back([&logger, id]() {
+                for (int i = 0; i < 500; ++i) {
+                    logger.saveMessage("Merge " + std::to_string(id) + " " + std::to_string(i), LogLevel::info);
+                    if (i % 50 == 0) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.flush();
+
+        std::vector<RecordPtr> records = ring->snapshot();
+        assert(records.size() == 2001 && "Not all merged records were dispatched");
+        for (size_t i = 1; i < records.size(); ++i) {
+            assert(records[i - 1]->time <= records[i]->time && "Records of different threads were not merged by time");
+        }
+    }
+
+    std::cout << "testThreadBufferingMergesAndHandsOffIdle passed\n";
+    std::filesystem::remove(logFile);
+}
+
+// С параметрами по умолчанию записи занятого и редко пишущего потоков выходят в порядке времени
+void testThreadBufferingDefaultsKeepOrder() {
+    const std::string logFile = "order_test_log.txt";
+    {
+        Logger logger(logFile, "info");
+        auto   ring = std::make_shared<RingSink>(8192);
+        logger.addSink(ring);
+        logger.enableThreadBuffering();
+
+        std::atomic<bool> done(false);
+        std::thread       quiet([&]() {
+            for (int i = 0; !done; ++i) {
+                logger.saveMessage("Quiet " + std::to_string(i), LogLevel::info);
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            }
+        });
+        std::thread busy([&]() {
+            for (int i = 0; i < 5000; ++i) {
+                logger.saveMessage("Busy " + std::to_string(i), LogLevel::info);
+                if (i % 100 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(7));
+                }
+            }
+        });
+        busy.join();
+        done = true;
+        quiet.join();
+        logger.flush();
+
+        std::vector<RecordPtr> records = ring->snapshot();
+        assert(records.size() > 5000 && "Not all records were dispatched");
+        for (size_t i = 1; i < records.size(); ++i) {
+            assert(records[i - 1]->time <= records[i]->time && "Records were reordered with default options");
+        }
+    }
+
+    std::cout << "testThreadBufferingDefaultsKeepOrder passed\n";
+    std::filesystem::remove(logFile);
+}
+
+// Проверка, что в установившемся режиме запись в журнал и сбор метрик не выделяют память
+void testSteadyStateDoesNotAllocate() {
+    const std::string logFile = "alloc_test_log.txt";
+    const std::string message = "Steady state message long enough to leave the small string buffer";
+    {
+        Logger        logger(logFile, "info");
+        SystemMonitor monitor(logger);
+
+        // Прогрев: пулы записей, кэш времени, открытые дескрипторы
+        for (int i = 0; i < 100; ++i) {
+            logger.saveMessage(message, LogLevel::info);
+        }
+        monitor.monitorCPU(LogLevel::info);
+        monitor.monitorMemory(LogLevel::info);
+        monitor.monitorDisk(LogLevel::info);
+
+        size_t before = allocationCount;
+        for (int i = 0; i < 1000; ++i) {
+            logger.saveMessage(message, LogLevel::info);
+            logger.saveMessage("Filtered out", LogLevel::unknown);
+        }
+        monitor.monitorCPU(LogLevel::info);
+        monitor.monitorMemory(LogLevel::info);
+        monitor.monitorDisk(LogLevel::info);
+        size_t allocations = allocationCount - before;
+
+        assert(allocations == 0 && "Steady state logging path allocated memory");
+    }
+
+    std::cout << "testSteadyStateDoesNotAllocate passed\n";
+    std::filesystem::remove(logFile);
+    std::filesystem::remove("output_app.txt");
+}
+
+// Рекурсия без хвостового вызова: переполняет стек потока, пока флаг установлен
+volatile bool keepRecursing = true;
+
+int overflowStack(int depth) {
+    volatile char frame[4096];
+    frame[0] = static_cast<char>(depth);
+    if (!keepRecursing) {
+        return frame[0];
+    }
+    return overflowStack(depth + 1) + frame[0];
+}
+
+// Аварийная запись при переполнении стека: обработчик SIGSEGV работает на альтернативном стеке
+void testLoggerCrashHandlerSurvivesStackOverflow() {
+    const std::string logFile = "overflow_test_log.txt";
+    std::filesystem::remove(logFile);
+
+    pid_t child = fork();
+    assert(child >= 0 && "fork failed");
+    if (child == 0) {
+        Logger              logger(logFile, "info");
+        ThreadBufferOptions options;
+        options.bufferRecords = 1024;
+        options.flushInterval = std::chrono::hours(1);
+        logger.enableThreadBuffering(options);
+        logger.enableCrashHandler();
+
+        for (int i = 0; i < 10; ++i) {
+            logger.saveMessage("Before overflow " + std::to_string(i), LogLevel::error);
+        }
+        std::_Exit(overflowStack(0));
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV && "Child must die from SIGSEGV");
+
+    std::ifstream file(logFile);
+    int           lineCount = 0;
+    std::string   line;
+    while (std::getline(file, line)) {
+        ++lineCount;
+    }
+    assert(lineCount == 10 && "Buffered records were lost on stack overflow");
+
+    std::cout << "testLoggerCrashHandlerSurvivesStackOverflow passed\n";
+    std::filesystem::remove(logFile);
+}
+
+// Проверка аварийной записи: при SIGABRT записи из буфера потока попадают в файл
+void testLoggerCrashHandlerDrainsBuffers() {
+    const std::string logFile = "crash_test_log.txt";
+    std::filesystem::remove(logFile);
+
+    pid_t child = fork();
+    assert(child >= 0 && "fork failed");
+    if (child == 0) {
+        Logger              logger(logFile, "info");
+        ThreadBufferOptions options;
+        options.bufferRecords = 1024;                       // Буфер не заполнится
+        options.flushInterval = std::chrono::hours(1);      // И таймер не сработает
+        logger.enableThreadBuffering(options);
+        logger.enableCrashHandler();
+
+        for (int i = 0; i < 10; ++i) {
+            logger.saveMessage("Before crash " + std::to_string(i), LogLevel::error);
+        }
+        std::abort();
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT && "Child must die from the original signal");
+
+    std::ifstream file(logFile);
+    int           lineCount = 0;
+    std::string   line;
+    while (std::getline(file, line)) {
+        assert(line.find("Before crash") != std::string::npos && "Unexpected line in crash log");
+        ++lineCount;
+    }
+    assert(lineCount == 10 && "Buffered records were lost on crash");
+
+    std::cout << "testLoggerCrashHandlerDrainsBuffers passed\n";
+    std::filesystem::remove(logFile);
+}
+
+// Потоков больше, чем слотов реестра аварийной записи: лишние потоки пишут синхронно, и при аварии ничего не теряется
+void testLoggerCrashHandlerKeepsAllRecords() {
+    const std::string logFile     = "crash_all_test_log.txt";
+    const int         parked      = 300;
+    const int         mainRecords = 200000;
+    std::filesystem::remove(logFile);
+
+    pid_t child = fork();
+    assert(child >= 0 && "fork failed");
+    if (child == 0) {
+        Logger              logger(logFile, "info");
+        ThreadBufferOptions options;
+        options.flushInterval = std::chrono::hours(1);  // Писатель выдаёт только наполовину заполненные кольца
+        options.reorderWindow = std::chrono::hours(1);
+        logger.enableThreadBuffering(options);
+        logger.enableCrashHandler();
+
+        for (int i = 0; i < mainRecords; ++i) {
+            logger.saveMessage("Main " + std::to_string(i), LogLevel::error);
+        }
+
+        // Каждый поток оставляет запись в своём кольце и не завершается до аварии
+        std::atomic<int>         written(0);
+        std::vector<std::thread> threads;
+        for (int id = 0; id < parked; ++id) {
+            threads.emplace_back([&logger, &written, id]() {
+                logger.saveMessage("Parked " + std::to_string(id), LogLevel::error);
+                ++written;
+                while (true) {
+                    std::this_thread::sleep_for(std::chrono::seconds(1));
+                }
+            });
+        }
+        while (written < parked) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::abort();
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT && "Child must die from the original signal");
+
+    // Запись, выданная писателем в момент сигнала, может попасть в файл дважды, поэтому считаем разные записи
+    std::vector<bool> parkedSeen(parked), mainSeen(mainRecords);
+    std::ifstream     file(logFile);
+    std::string       line;
+    while (std::getline(file, line)) {
+        int number;
+        if (std::sscanf(line.c_str(), "%*[^]]][ERROR] Parked %d", &number) == 1) {
+            parkedSeen[number] = true;
+        } else if (std::sscanf(line.c_str(), "%*[^]]][ERROR] Main %d", &number) == 1) {
+            mainSeen[number] = true;
+        }
+    }
+    assert(std::count(parkedSeen.begin(), parkedSeen.end(), true) == parked && "Records of parked threads were lost");
+    assert(std::count(mainSeen.begin(), mainSeen.end(), true) == mainRecords && "Records were lost on crash");
+
+    std::cout << "testLoggerCrashHandlerKeepsAllRecords passed\n";
+    std::filesystem::remove(logFile);
+}
+
+// Аварийная запись с журналом через io_uring: выданные приёмнику записи дописываются из его буферов на свои места,
+// а записи из колец потоков ложатся за ними
+void testLoggerCrashHandlerDrainsIoUringJournal() {
+    const std::string logFile = "crash_uring_test_log.txt";
+
+    for (auto submitInterval : {std::chrono::milliseconds(0), std::chrono::milliseconds(100)}) {
+        std::filesystem::remove(logFile);
+
+        pid_t child = fork();
+        assert(child >= 0 && "fork failed");
+        if (child == 0) {
+            Logger logger(logFile, "info");
+            logger.enableIoUringJournal(64 * 1024, 4, submitInterval);
+            logger.enableThreadBuffering();
+            logger.enableCrashHandler();
+
+            for (int i = 0; i < 100; ++i) {
+                logger.saveMessage("Early " + std::to_string(i), LogLevel::error);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));  // Записи уже в буфере приёмника
+            for (int i = 0; i < 10; ++i) {
+                logger.saveMessage("Late " + std::to_string(i), LogLevel::error);
+            }
+            std::abort();
+        }
+
+        int status = 0;
+        waitpid(child, &status, 0);
+        assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT && "Child must die from the original signal");
+
+        // Поздняя запись, выданная писателем в момент сигнала, может попасть в файл дважды
+        std::vector<bool> earlySeen(100), lateSeen(10);
+        std::ifstream     file(logFile);
+        std::string       line;
+        while (std::getline(file, line)) {
+            int number;
+            if (std::sscanf(line.c_str(), "%*[^]]][ERROR] Early %d", &number) == 1) {
+                assert(!earlySeen[number] && "Early record was written twice");
+                assert(std::count(lateSeen.begin(), lateSeen.end(), true) == 0 && "Late record overwrote early ones");
+                earlySeen[number] = true;
+            } else if (std::sscanf(line.c_str(), "%*[^]]][ERROR] Late %d", &number) == 1) {
+                lateSeen[number] = true;
+            } else {
+                assert(false && "Corrupted line in crash log");
+            }
+        }
+        assert(std::count(earlySeen.begin(), earlySeen.end(), true) == 100 && "Records in io_uring buffers were lost");
+        assert(std::count(lateSeen.begin(), lateSeen.end(), true) == 10 && "Records in thread rings were lost");
+    }
+
+    std::cout << "testLoggerCrashHandlerDrainsIoUringJournal passed\n";
+    std::filesystem::remove(logFile);
+}
+
+// Проверка выборки по времени и уровню через индекс
+void testLogReaderRangeQuery() {
+    const std::string logFile = "reader_test_log.txt";
+    {
+        // Журнал за 100 секунд: каждую секунду INFO, каждую десятую ещё и ERROR
+        std::ofstream file(logFile);
+        for (int second = 0; second < 100; ++second) {
+            char time[32];
+            std::snprintf(time, sizeof(time), "2025-01-24 16:%02d:%02d", 40 + second / 60, second % 60);
+            file << "[" << time << "][INFO] Tick " << second << "\n";
+            if (second % 10 == 5) {
+                file << "[" << time << "][ERROR] Failure " << second << "\n";
+            }
+        }
+    }
+
+    LogReader reader(logFile);
+    assert(!reader.loadIndex() && "Index must not exist before build");
+    reader.buildIndex(10);
+    assert(reader.getBlockCount() == 10 && "Expected one index block per 10 seconds");
+
+    LogQuery query;
+    query.from     = "2025-01-24 16:40:20";
+    query.to       = "2025-01-24 16:40:59";
+    query.minLevel = LogLevel::warning;
+
+    std::vector<std::string> lines;
+    size_t matched = reader.query(query, [&lines](std::string_view line) { lines.emplace_back(line); });
+    assert(matched == 4 && lines.size() == 4 && "Wrong number of lines in range");
+    assert(lines.front().find("Failure 25") != std::string::npos && "Wrong first line in range");
+    assert(lines.back().find("Failure 55") != std::string::npos && "Wrong last line in range");
+
+    // Индекс с диска даёт тот же результат
+    LogReader reloaded(logFile);
+    assert(reloaded.loadIndex() && "Index was not saved");
+    query.minLevel = LogLevel::info;
+    assert(reloaded.query(query, [](std::string_view) {}) == 44 && "Wrong number of lines with loaded index");
+
+    std::cout << "testLogReaderRangeQuery passed\n";
+    std::filesystem::remove(logFile);
+    std::filesystem::remove(indexPathFor(logFile));
+}
+
+// Запоздавшая запись попадает в более поздний блок индекса, но находится по своему времени
+void testLogReaderFindsLateRecords() {
+    const std::string logFile = "late_reader_test_log.txt";
+    {
+        std::ofstream file(logFile);
+        file << "[2025-01-24 16:40:00][INFO] First\n";
+        file << "[2025-01-24 16:40:10][INFO] Next block\n";
+        file << "[2025-01-24 16:40:09][ERROR] Late\n";
+        file << "[2025-01-24 16:40:11][INFO] After\n";
+    }
+
+    LogReader reader(logFile);
+    reader.buildIndex(10);
+    assert(reader.getBlockCount() == 2 && "Late record must not open a new block");
+
+    LogQuery query;
+    query.from = "2025-01-24 16:40:00";
+    query.to   = "2025-01-24 16:40:09";
+
+    std::vector<std::string> lines;
+    reader.query(query, [&lines](std::string_view line) { lines.emplace_back(line); });
+    assert(lines.size() == 2 && "Late record was not found");
+    assert(lines.back().find("Late") != std::string::npos);
+
+    query.from     = "2025-01-24 16:40:05";
+    query.minLevel = LogLevel::error;
+    assert(reader.query(query, [](std::string_view) {}) == 1 && "Late record was not found by level");
+
+    std::cout << "testLogReaderFindsLateRecords passed\n";
+    std::filesystem::remove(logFile);
+    std::filesystem::remove(indexPathFor(logFile));
+}
+
+// Проверка, что логгер ведёт индекс по мере записи
+void testLoggerWritesTimeIndex() {
+    const std::string logFile = "indexed_test_log.txt";
+    {
+        Logger logger(logFile, "info");
+        logger.saveMessage("Before index", LogLevel::error);
+        logger.enableTimeIndex(1);
+        for (int i = 0; i < 100; ++i) {
+            logger.saveMessage("Indexed " + std::to_string(i), i % 10 ? LogLevel::info : LogLevel::warning);
+        }
+    }
+
+    LogReader reader(logFile);
+    assert(reader.loadIndex() && reader.getBlockCount() >= 1 && "Logger did not write index");
+
+    LogQuery query;
+    query.minLevel = LogLevel::warning;
+    assert(reader.query(query, [](std::string_view) {}) == 11 && "Indexed query lost records");
+
+    std::cout << "testLoggerWritesTimeIndex passed\n";
+    std::filesystem::remove(logFile);
+    std::filesystem::remove(indexPathFor(logFile));
+}
+
+// Проверка записи через io_uring и через запасной путь pwrite, в том числе при ротации файла
+void testIoUringFileSink() {
+    const std::string logFile     = "test_log.txt";
+    const std::string uringFile   = "uring_test_log.txt";
+    const std::string rotatedFile = "uring_rotated_test_log.txt";
+
+    auto countLines = [](const std::string& name) {
+        std::ifstream file(name);
+        int           lineCount = 0;
+        std::string   line;
+        while (std::getline(file, line)) {
+            assert(line.find("Uring message") != std::string::npos && "Corrupted line in io_uring sink");
+            ++lineCount;
+        }
+        return lineCount;
+    };
+
+    for (bool tryIoUring : {true, false}) {
+        {
+            Logger logger(logFile, "info");
+            auto   sink = std::make_shared<IoUringFileSink>(uringFile, LogLevel::unknown, 4096, 3, tryIoUring);
+            assert((tryIoUring || !sink->usesIoUring()) && "Fallback was requested");
+            logger.addSink(sink);
+
+            for (int i = 0; i < 5000; ++i) {
+                logger.saveMessage("Uring message " + std::to_string(i), LogLevel::info);
+            }
+            logger.flush();
+            assert(countLines(uringFile) == 5000 && "Not all messages were written before rotation");
+
+            sink->rotate(rotatedFile);
+            for (int i = 0; i < 3000; ++i) {
+                logger.saveMessage("Uring message " + std::to_string(i), LogLevel::info);
+            }
+
+            // Неполный буфер отправляет таймер, без flush
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            assert(countLines(rotatedFile) == 3000 && "Partial buffer was not submitted by the timer");
+        }
+
+        assert(countLines(uringFile) == 5000 && "Old file changed after rotation");
+        assert(countLines(rotatedFile) == 3000 && "Not all messages were written after rotation");
+
+        std::filesystem::remove(logFile);
+        std::filesystem::remove(uringFile);
+        std::filesystem::remove(rotatedFile);
+    }
+
+    std::cout << "testIoUringFileSink passed\n";
+}
+
+// Основной журнал через io_uring: sync и rotate из другого потока, пока буферизованный логгер пишет
+void testLoggerIoUringJournal() {
+    const std::string logFile     = "uring_journal_test_log.txt";
+    const std::string rotatedFile = "uring_journal_rotated_test_log.txt";
+    {
+        Logger logger(logFile, "info");
+        logger.enableIoUringJournal(4096, 3, std::chrono::milliseconds(0));
+        logger.enableTimeIndex(1);
+
+        // FileSink дописал бы строку сразу, io_uring без таймера держит её в буфере до flush
+        logger.saveMessage("Journal message buffered", LogLevel::info);
+        assert(std::filesystem::file_size(logFile) == 0 && "Main journal is still written by FileSink");
+        logger.syncJournal();
+        assert(std::filesystem::file_size(logFile) > 0 && "syncJournal did not write buffered records");
+
+        ThreadBufferOptions options;
+        options.bufferRecords = 64;
+        logger.enableThreadBuffering(options);
+
+        // Ротация посреди записи: когда потоки сделали половину сообщений
+        std::atomic<bool> running{true};
+        std::atomic<int>  written{0};
+        std::thread       maintenance([&]() {
+            bool rotated = false;
+            while (running) {
+                logger.syncJournal();
+                if (!rotated && written >= 4 * 1000) {
+                    logger.rotateJournal(rotatedFile);
+                    rotated = true;
+                }
+            }
+        });
+
+        std::vector<std::thread> threads;
+        for (int id = 0; id < 4; ++id) {
+            threads.emplace_back([&, id]() {
+                for (int i = 0; i < 2000; ++i) {
+                    logger.saveMessage("Journal message " + std::to_string(id) + " " + std::to_string(i),
+                                       LogLevel::info);
+                    ++written;
+                    // Вторая половина ждёт ротации, чтобы в новом файле гарантированно были записи
+                    while (i == 1000 && !std::filesystem::exists(rotatedFile)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        running = false;
+        maintenance.join();
+    }
+
+    int lineCount = 0;
+    for (const std::string& name : {logFile, rotatedFile}) {
+        std::ifstream file(name);
+        std::string   line;
+        while (std::getline(file, line)) {
+            assert(line.find("[INFO] Journal message ") != std::string::npos && "Corrupted line in io_uring journal");
+            ++lineCount;
+        }
+    }
+    assert(lineCount == 1 + 4 * 2000 && "Records were lost during sync and rotation");
+
+    LogReader reader(rotatedFile);
+    assert(reader.loadIndex() && "Index was not continued for the rotated journal");
+
+    std::cout << "testLoggerIoUringJournal passed\n";
+    for (const std::string& name : {logFile, rotatedFile}) {
+        std::filesystem::remove(name);
+        std::filesystem::remove(indexPathFor(name));
+    }
+}
+
+// Один CachedFile из нескольких потоков (output_app.txt в режиме "all"): дескриптор открывается один раз
+void testCachedFileSharedBetweenThreads() {
+    const std::string outputFile = "cached_test_output.txt";
+    auto countFds = []() {
+        return std::distance(std::filesystem::directory_iterator("/proc/self/fd"), std::filesystem::directory_iterator());
+    };
+    const auto fdsBefore = countFds();
+    {
+        CachedFile               file(outputFile, O_WRONLY | O_CREAT | O_APPEND);
+        std::vector<std::thread> threads;
+        for (int id = 0; id < 8; ++id) {
+            threads.emplace_back([&file]() {
+                for (int i = 0; i < 100; ++i) {
+                    assert(file.appendLine("Cached line") && "appendLine failed");
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(countFds() == fdsBefore + 1 && "Concurrent first use opened extra descriptors");
+    }
+    assert(countFds() == fdsBefore && "Descriptor leaked");
+
+    std::ifstream file(outputFile);
+    int           lineCount = 0;
+    std::string   line;
+    while (std::getline(file, line)) {
+        assert(line == "Cached line" && "Interleaved write");
+        ++lineCount;
+    }
+    assert(lineCount == 800 && "Lines were lost");
+
+    std::filesystem::remove(outputFile);
+    std::cout << "testCachedFileSharedBetweenThreads passed\n";
+}
+
+// Триггеры PSI: сообщение ERROR о срабатывании и остановка ждущих потоков без задержки опроса
+void testPressureTriggers() {
+    const std::string logFile    = "pressure_test_log.txt";
+    const bool        psiPresent = std::filesystem::exists("/proc/pressure/cpu") &&
+                            std::filesystem::exists("/proc/pressure/memory") &&
+                            std::filesystem::exists("/proc/pressure/io");
+    {
+        Logger          logger(logFile, "info");
+        SystemMonitor   monitor(logger);
+        PressureTrigger trigger(PressureResource::cpu);
+        assert((!psiPresent || trigger.isAvailable()) && "PSI trigger was not registered");
+
+        if (trigger.isAvailable()) {
+            monitor.reportPressure(trigger, LogLevel::info);
+        }
+
+        SystemMonitorManager manager(monitor, "all", LogLevel::info, true);
+        manager.startMonitoring(LogLevel::info);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        auto start = std::chrono::steady_clock::now();
+        manager.stopMonitoring();
+        auto stopTime = std::chrono::steady_clock::now() - start;
+        assert((!psiPresent || stopTime < std::chrono::seconds(1)) && "Pressure watchers did not wake up on stop");
+    }
+
+    if (psiPresent) {
+        std::ifstream file(logFile);
+        std::string   line;
+        bool          found = false;
+        while (std::getline(file, line)) {
+            found = found || line.find("[ERROR] CPU pressure stall detected: some avg10=") != std::string::npos;
+        }
+        assert(found && "Pressure event was not logged");
+    }
+
+    std::filesystem::remove(logFile);
+    std::cout << "testPressureTriggers passed\n";
+}
+
+// В режиме PSI потоки не только ждут триггеры, но и редко замеряют загрузку, память и заполненность диска
+void testPressureKeepsPolling() {
+    const std::string logFile    = "pressure_poll_test_log.txt";
+    const bool        psiPresent = std::filesystem::exists("/proc/pressure/cpu");
+    {
+        Logger          logger(logFile, "info");
+        SystemMonitor   monitor(logger);
+        SamplingOptions options;
+        options.maxPeriod = std::chrono::milliseconds(50);
+
+        SystemMonitorManager manager(monitor, "all", LogLevel::info, true, options);
+        manager.startMonitoring(LogLevel::info);
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+        for (MonitorMetric metric : {MonitorMetric::cpu, MonitorMetric::memory, MonitorMetric::disk}) {
+            const SamplingStats stats = manager.getSamplingStats(metric);
+            assert(stats.samples >= 3 && "Metric was not polled next to the PSI trigger");
+            assert((!psiPresent || stats.currentPeriod == options.maxPeriod) && "Polling in PSI mode is not slow");
+        }
+        manager.stopMonitoring();
+    }
+
+    std::ifstream file(logFile);
+    std::string   content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    assert(content.find("Average CPU Load") != std::string::npos && "CPU load was not logged");
+    assert(content.find("Memory Usage") != std::string::npos && "Memory usage was not logged");
+    assert(content.find("Disk usage for root filesystem") != std::string::npos && "Disk usage was not logged");
+
+    std::filesystem::remove(logFile);
+    std::filesystem::remove("output_app.txt");
+    std::cout << "testPressureKeepsPolling passed\n";
+}
+
+// Сборщики cgroup v2 на подставном каталоге: проценты считаются от лимитов контейнера
+void testCgroupCollectors() {
+    const std::string logFile  = "cgroup_test_log.txt";
+    const std::string root     = "fake_cgroup";
+    const std::string dir      = root + "/system.slice/app.scope";
+    const std::string procFile = "fake_proc_cgroup";
+
+    auto writeFile = [](const std::string& name, const std::string& content) {
+        std::ofstream file(name);
+        file << content;
+    };
+    std::filesystem::create_directories(dir);
+    writeFile(dir + "/cgroup.controllers", "cpu io memory\n");
+    writeFile(dir + "/memory.current", "536870912\n");
+    writeFile(dir + "/memory.max", "1073741824\n");
+    writeFile(dir + "/cpu.stat", "usage_usec 1000\nuser_usec 800\nsystem_usec 200\n");
+    writeFile(dir + "/cpu.max", "200000 100000\n");
+    writeFile(dir + "/io.stat", "8:0 rbytes=1048576 wbytes=2097152 rios=1 wios=2 dbytes=0 dios=0\n"
+                                "8:16 rbytes=1048576 wbytes=0 rios=1 wios=0 dbytes=0 dios=0\n");
+    writeFile(dir + "/io.max", "8:0 rbps=max wbps=4194304 riops=max wiops=max\n");
+    writeFile(procFile, "4:memory:/ignored\n0::/system.slice/app.scope\n");
+
+    assert(findCgroupDir(procFile, {"missing_mount", root}) == dir && "cgroup v2 directory was not found");
+
+    CgroupStats stats(dir);
+    long long   current, limit, readBytes, writeBytes, readBps, writeBps;
+    assert(stats.hasMemory() && stats.hasCpu() && stats.hasIo());
+    assert(stats.readMemory(current, limit) && current == 536870912 && limit == 1073741824);
+    assert(stats.readCpuLimit() == 2.0 && "cpu.max quota/period mismatch");
+    assert(stats.readIo(readBytes, writeBytes) && readBytes == 2097152 && writeBytes == 2097152);
+    stats.readIoLimit(readBps, writeBps);
+    assert(readBps == 0 && writeBps == 4194304);
+
+    {
+        Logger        logger(logFile, "info");
+        SystemMonitor monitor(logger, dir);
+        monitor.monitorMemory(LogLevel::info);
+        monitor.monitorCPU(LogLevel::info);
+        monitor.monitorIO(LogLevel::info);
+    }
+
+    std::ifstream file(logFile);
+    std::string   content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    assert(content.find("[INFO] Memory Usage: 0.5 GB used of 1 GB cgroup limit (50%)") != std::string::npos);
+    assert(content.find("of 2 CPUs (cgroup)") != std::string::npos && "CPU load was not computed against cpu.max");
+    assert(content.find("IO Throughput: read") != std::string::npos);
+
+    // Без лимитов (обычный юнит systemd на хосте) — данные хоста, если cgroup не выбрана явно
+    writeFile(procFile, "0::/\n");
+    assert(inCgroupNamespace(procFile) && "cgroup namespace root was not detected");
+    writeFile(procFile, "0::/system.slice/app.scope\n");
+    assert(!inCgroupNamespace(procFile) && "Host cgroup path was taken for a namespace");
+
+    writeFile(dir + "/memory.max", "max\n");
+    writeFile(dir + "/cpu.max", "max 100000\n");
+    assert(!CgroupStats(dir).hasLimit() && "Unlimited cgroup reported a limit");
+
+    auto collect = [&](CgroupMode mode) {
+        std::filesystem::remove(logFile);
+        {
+            Logger        logger(logFile, "info");
+            SystemMonitor monitor(logger, dir, mode);
+            monitor.monitorMemory(LogLevel::info);
+            monitor.monitorCPU(LogLevel::info);
+        }
+        std::ifstream logStream(logFile);
+        return std::string((std::istreambuf_iterator<char>(logStream)), std::istreambuf_iterator<char>());
+    };
+    if (!inCgroupNamespace()) {
+        content = collect(CgroupMode::automatic);
+        assert(content.find("cgroup") == std::string::npos && "Unlimited host cgroup replaced /proc");
+    }
+    content = collect(CgroupMode::always);
+    assert(content.find("(cgroup)") != std::string::npos && "Explicit cgroup mode was ignored");
+    content = collect(CgroupMode::never);
+    assert(content.find("cgroup") == std::string::npos && "cgroup was used despite CgroupMode::never");
+
+    std::filesystem::remove_all(root);
+    std::filesystem::remove(procFile);
+    std::filesystem::remove(logFile);
+    std::filesystem::remove("output_app.txt");
+    std::cout << "testCgroupCollectors passed\n";
+}
+
+// Адаптивный период опроса: рост до максимума при стабильной метрике, минимум в полосе error,
+// при этом повторяющиеся строки в журнал пишутся не чаще reportInterval
+void testAdaptiveSampling() {
+    const std::string logFile = "sampling_test_log.txt";
+    const std::string dir     = "fake_sampling_cgroup";
+
+    auto setMemory = [&dir](const std::string& current) {
+        std::ofstream file(dir + "/memory.current");
+        file << current << "\n";
+    };
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir + "/memory.max") << "1073741824\n";
+    setMemory("268435456");  // 25%
+
+    auto waitFor = [](SystemMonitorManager& manager, std::chrono::milliseconds period) {
+        for (int i = 0; i < 2000 && manager.getSamplingStats(MonitorMetric::memory).currentPeriod != period; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return manager.getSamplingStats(MonitorMetric::memory).currentPeriod == period;
+    };
+
+    {
+        Logger          logger(logFile, "info");
+        SystemMonitor   monitor(logger, dir);
+        SamplingOptions options;
+        options.minPeriod = std::chrono::milliseconds(20);
+        options.maxPeriod = std::chrono::milliseconds(160);
+
+        SystemMonitorManager manager(monitor, "memory", LogLevel::info, false, options);
+        manager.startMonitoring(LogLevel::info);
+        assert(waitFor(manager, options.maxPeriod) && "Stable metric did not back off to the maximum period");
+
+        setMemory("966367641");  // 90%
+        assert(waitFor(manager, options.minPeriod) && "Metric in error band is not sampled at the minimum period");
+        const uint64_t errorSamples = manager.getSamplingStats(MonitorMetric::memory).samples;
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        assert(manager.getSamplingStats(MonitorMetric::memory).currentPeriod == options.minPeriod &&
+               "Stable metric in error band backed off");
+        assert(manager.getSamplingStats(MonitorMetric::memory).samples >= errorSamples + 5);
+
+        SamplingStats stats = manager.getSamplingStats(MonitorMetric::memory);
+        assert(stats.minPeriod == options.minPeriod && stats.maxPeriod == options.maxPeriod);
+        assert(stats.samples >= 4 && stats.lastValue > 80);
+        assert(manager.getSamplingStats(MonitorMetric::cpu).currentPeriod.count() == 0 && "CPU is not sampled");
+
+        // Остановка не ждёт окончания длинного периода
+        setMemory("268435456");
+        SamplingOptions slowOptions;
+        slowOptions.minPeriod = std::chrono::milliseconds(10);
+        SystemMonitorManager slowManager(monitor, "memory", LogLevel::info, false, slowOptions);
+        slowManager.startMonitoring(LogLevel::info);
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+        auto start = std::chrono::steady_clock::now();
+        slowManager.stopMonitoring();
+        assert(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200) && "Stop waited for sampling");
+    }
+
+    // Десятки замеров в полосе error за доли секунды — одна строка ERROR
+    std::ifstream file(logFile);
+    std::string   line;
+    int           errorLines = 0;
+    while (std::getline(file, line)) {
+        errorLines += line.find("[ERROR] Memory Usage") != std::string::npos;
+    }
+    assert(errorLines == 1 && "Stable value in error band was logged on every sample");
+
+    std::filesystem::remove_all(dir);
+    std::filesystem::remove(logFile);
+    std::filesystem::remove("output_app.txt");
+    std::cout << "testAdaptiveSampling passed\n";
+}
+
 std::atomic<bool>        running(true);
 std::mutex               threadsMutex;
 std::vector<std::thread> monitoringThreads;
@@ -319,6 +1288,27 @@ int main() {
     testLoggerClosesFile();
     testLoggerLargeDataVolume();
     testLoggerInvalidLogLevel();
+    testLoggerPerSinkLevels();
+    testRingSinkOverwritesOldest();
+    testMmapFileSink();
+    testLoggerThreadBuffering();
+    testThreadBufferingMergesAndHandsOffIdle();
+    testThreadBufferingDefaultsKeepOrder();
+    testSteadyStateDoesNotAllocate();
+    testLoggerCrashHandlerDrainsBuffers();
+    testLoggerCrashHandlerSurvivesStackOverflow();
+    testLoggerCrashHandlerKeepsAllRecords();
+    testLoggerCrashHandlerDrainsIoUringJournal();
+    testLogReaderRangeQuery();
+    testLogReaderFindsLateRecords();
+    testLoggerWritesTimeIndex();
+    testIoUringFileSink();
+    testLoggerIoUringJournal();
+    testCachedFileSharedBetweenThreads();
+    testPressureTriggers();
+    testPressureKeepsPolling();
+    testCgroupCollectors();
+    testAdaptiveSampling();
 
     // application
 